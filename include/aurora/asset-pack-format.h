@@ -0,0 +1,48 @@
+#ifndef __PROJECT_AURORA_ASSET_PACK_FORMAT_HEADER_H__
+#define __PROJECT_AURORA_ASSET_PACK_FORMAT_HEADER_H__
+
+#include <array>
+#include <cstdint>
+
+// This header is also used by tools/pack-assets.cpp, so it must not depend on the game's libraries.
+
+namespace Game
+{
+namespace AssetPackFormat
+{
+
+// ---------------------------------------------------
+
+/*
+	Layout of the asset pack:
+	- Header
+	- Entry array, sorted by name
+	- Names, not null-terminated
+	- Data of each entry, aligned to alignment bytes
+*/
+
+inline constexpr std::array<char, 8> magic = { 'A', 'U', 'R', 'P', 'A', 'C', 'K', '0' };
+inline constexpr uint32_t version = 1;
+inline constexpr uint64_t alignment = 64;
+
+struct Header {
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t n_entries;
+	uint64_t names_offset;
+	uint64_t names_size;
+};
+
+struct Entry {
+	uint64_t name_offset; // relative to names_offset
+	uint64_t name_size;
+	uint64_t offset; // from the beginning of the file
+	uint64_t size;
+};
+
+// ---------------------------------------------------
+
+} // end namespace AssetPackFormat
+} // end namespace Game
+
+#endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+#ifndef __PROJECT_AURORA_ASSET_PACK_HEADER_H__
+#define __PROJECT_AURORA_ASSET_PACK_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <SDL.h>
+
+#include <span>
+#include <string_view>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/types.h>
+#include <aurora/mapped-file.h>
+#include <aurora/asset-pack-format.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Read-only archive built by tools/pack-assets.
+	The whole archive is a single memory-mapped file, and the data of each
+	entry is served as a span into the mapping, without any copy.
+*/
+
+class AssetPack
+{
+private:
+	MappedFile file;
+	std::span<const AssetPackFormat::Entry> entries;
+	std::string_view names;
+
+	std::string_view get_name (const AssetPackFormat::Entry& entry) const noexcept
+	{
+		return this->names.substr(entry.name_offset, entry.name_size);
+	}
+
+public:
+	// returns false if the pack doesn't exist or is corrupted
+	bool open (const char *fname);
+
+	bool is_open () const noexcept
+	{
+		return this->file.is_open();
+	}
+
+	// empty span if there is no such entry
+	std::span<std::byte> find (const std::string_view name) const noexcept;
+};
+
+// ---------------------------------------------------
+
+/*
+	Contents of an asset, either a span into the pack or a mapped loose file.
+*/
+
+class AssetFile
+{
+private:
+	MappedFile loose;
+	std::span<std::byte> data;
+
+	friend class AssetFiles;
+
+public:
+	bool is_open () const noexcept
+	{
+		return !this->data.empty();
+	}
+
+	std::span<std::byte> get_data () const noexcept
+	{
+		return this->data;
+	}
+
+	// the data must outlive the returned stream
+	SDL_RWops* make_rwops () const
+	{
+		return SDL_RWFromConstMem(this->data.data(), this->data.size());
+	}
+};
+
+// ---------------------------------------------------
+
+/*
+	Virtual file layer.
+	Assets are looked up by their path (e.g., "assets/grass.png") in the
+	asset pack, and only when the pack doesn't have them they are loaded
+	from the loose files, so the game also runs without a pack.
+	Opening files is thread-safe.
+*/
+
+class AssetFiles
+{
+private:
+	AssetPack pack;
+
+public:
+	bool open_pack (const char *fname)
+	{
+		return this->pack.open(fname);
+	}
+
+	// returns false if the asset doesn't exist
+	bool open (AssetFile& file, const char *fname) const;
+};
+
+inline AssetFiles asset_files;
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef __PROJECT_AURORA_BLUEPRINT_HEADER_H__
+#define __PROJECT_AURORA_BLUEPRINT_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/types.h>
+#include <aurora/object.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+// props are StaticObjectSprite
+
+struct Blueprint {
+	Object::Subtype subtype;
+
+	TextureDescriptor *texture;
+
+	Vector3 collider_size; // zero means no collider
+	Vector2 sprite_size;
+	Vector2 sprite_source_anchor;
+	Vector3 sprite_dest_anchor;
+};
+
+// ---------------------------------------------------
+
+/*
+	Blueprints of the props, loaded at startup from a text file
+	(Config::blueprints_fname), so they can be tuned without recompiling.
+	They are stored in a dense array indexed by Object::Subtype, so getting
+	a blueprint is a direct index.
+	Every line of the file is validated against the subtypes of the
+	Object::Subtype X-macro and the known textures.
+*/
+
+class BlueprintRegistry
+{
+private:
+	std::array<Blueprint, Object::n_subtypes> blueprints;
+	std::array<bool, Object::n_subtypes> loaded = {};
+
+	void parse (const std::string_view text, const char *fname);
+
+public:
+	void load (const char *fname);
+
+	const Blueprint& get (const Object::Subtype subtype) const
+	{
+		mylib_assert_msg(this->loaded[ std::to_underlying(subtype) ], "blueprint not found for ", subtype);
+		return this->blueprints[ std::to_underlying(subtype) ];
+	}
+};
+
+inline BlueprintRegistry blueprint_registry;
+
+// ---------------------------------------------------
+
+// adds the blueprint's collider to the object, unless the blueprint has none
+void add_blueprint_collider (StaticObject *obj, const Blueprint& blueprint);
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
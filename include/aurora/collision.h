@@ -16,6 +16,7 @@
 
 #include <aurora/config.h>
 #include <aurora/types.h>
+#include <aurora/physics.h>
 
 
 namespace Game
@@ -42,9 +43,11 @@ struct Collider
 	// id of the collider
 	uint32_t id;
 
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
+	// box of the collider at the owner object's position
+	ColliderBox get_box () const noexcept;
+
+	// records the collider in the debug-draw layer
 	void render (const Color& color) const;
-#endif
 };
 
 // ---------------------------------------------------
@@ -18,17 +18,10 @@ namespace Config
 
 // ---------------------------------------------------
 
-#define AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
+// initial state of the debug-draw layer, it can be toggled at runtime (F1 and F2)
 
-// ---------------------------------------------------
-
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
-	inline constexpr bool render_colliders = true;
-#else
-	inline constexpr bool render_colliders = false;
-#endif
-
-inline constexpr bool render_sprite_box = true;
+inline constexpr bool render_colliders = false;
+inline constexpr bool render_sprite_box = false;
 
 // ---------------------------------------------------
 
@@ -55,6 +48,50 @@ inline constexpr bool sleep_to_save_cpu = true;
 
 inline constexpr bool busy_wait_to_ensure_fps = true;
 
+// The simulation runs in steps of simulation_dt, independently of the frame rate.
+// Rendering interpolates between the last two steps.
+// If disabled, the simulation is updated once per frame with the frame's dt.
+inline constexpr bool fixed_timestep = true;
+
+inline constexpr float simulation_fps = 60.0f;
+
+inline constexpr float simulation_dt = 1.0f / simulation_fps;
+
+// avoids the spiral of death when a frame takes too long: the remaining time is dropped
+inline constexpr uint32_t max_simulation_steps_per_frame = 8;
+
+// absolute-deadline sleeps with a short final spin, instead of sleep_to_save_cpu and busy_wait_to_ensure_fps (see FramePacer)
+inline constexpr bool precise_frame_pacing = true;
+
+// build the vertex streams of frame N in a separate thread while frame N+1 is simulated
+inline constexpr bool threaded_render = true;
+
+// ---------------------------------------------------
+
+// maximum number of simultaneous visual effects of each type (e.g., explosions)
+inline constexpr uint32_t max_effects_per_type = 4096;
+
+// colliders are stored inside the objects, so adding them never allocates memory
+inline constexpr uint32_t max_colliders_per_object = 4;
+
+// frequently spawned objects are recycled by pools that grow by chunks of this size
+inline constexpr uint32_t object_pool_chunk_size = 64;
+
+// heap allocations are reported for the frames after these, once pools and buffers reached their steady size
+inline constexpr uint32_t heap_stats_warmup_frames = 300;
+
+// ---------------------------------------------------
+
+// assets are loaded from this pack when it exists (see tools/pack-assets.cpp), otherwise from the loose files
+inline constexpr const char *asset_pack_fname = "assets.pack";
+
+// decoded textures are baked into this file, and loaded from it while the source images don't change
+inline constexpr bool use_texture_cache = true;
+inline constexpr const char *texture_cache_fname = "assets/textures.cache";
+
+// blueprints of the props, loaded at startup, so they can be tuned without recompiling
+inline constexpr const char *blueprints_fname = "data/blueprints.txt";
+
 // ---------------------------------------------------
 
 } // end namespace Config
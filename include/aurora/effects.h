@@ -0,0 +1,123 @@
+#ifndef __PROJECT_AURORA_EFFECTS_HEADER_H__
+#define __PROJECT_AURORA_EFFECTS_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <SDL.h>
+
+#include <vector>
+#include <array>
+#include <span>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <my-game-lib/my-game-lib.h>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/graphics.h>
+#include <aurora/random.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+enum class EffectType : uint32_t {
+	Explosion
+};
+
+inline constexpr uint32_t n_effect_types = 1;
+
+// ---------------------------------------------------
+
+/*
+	Short-lived visual effects (e.g., explosions) don't need to be objects.
+	Each effect type has a fixed-capacity pool stored as structure-of-arrays.
+	Slots are recycled with swap-and-pop, so emitting and expiring effects
+	never allocates memory.
+	Live effects are recorded as sprite instances into the frame snapshot.
+*/
+
+class EffectPool
+{
+public:
+	// we process 4 floats at a time
+	static constexpr uint32_t simd_width = 4;
+
+private:
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(uint32_t, capacity)
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint32_t, n_alive, 0)
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint64_t, n_dropped, 0)
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(float, frame_duration)
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(float, life_span)
+
+	// one sprite per animation frame, without owner object
+	std::vector<Sprite> frames;
+
+	std::vector<float> pos_x;
+	std::vector<float> pos_y;
+	std::vector<float> pos_z;
+	std::vector<float> age;
+
+public:
+	EffectPool () = default;
+	EffectPool (const uint32_t capacity_, const std::span<TextureDescriptor> textures, const Vector2 size_, const Vector2 source_anchor_, const Vector3& dest_anchor_, const float frame_duration_);
+
+	void emit (const Point& pos) noexcept;
+
+	// n effects uniformly scattered in center +- spread, with the positions drawn straight into the arrays
+	void emit_scattered (const Point& center, const Vector& spread, const uint32_t n, RandomGenerator& gen) noexcept;
+
+	void update (const float dt) noexcept;
+	void render ();
+};
+
+// ---------------------------------------------------
+
+class EffectSystem
+{
+private:
+	std::array<EffectPool, n_effect_types> pools;
+
+public:
+	EffectSystem ();
+
+	void emit (const EffectType type, const Point& pos) noexcept
+	{
+		this->pools[ std::to_underlying(type) ].emit(pos);
+	}
+
+	// uses the effects random stream, so it must only be called from the main thread
+	void emit_scattered (const EffectType type, const Point& center, const Vector& spread, const uint32_t n) noexcept
+	{
+		this->pools[ std::to_underlying(type) ].emit_scattered(center, spread, n, random_service.get_stream(RandomService::System::Effects));
+	}
+
+	void update (const float dt) noexcept
+	{
+		for (EffectPool& pool : this->pools)
+			pool.update(dt);
+	}
+
+	void render ()
+	{
+		for (EffectPool& pool : this->pools)
+			pool.render();
+	}
+
+	EffectPool& get_pool (const EffectType type) noexcept
+	{
+		return this->pools[ std::to_underlying(type) ];
+	}
+};
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef __PROJECT_AURORA_FRAME_PACER_HEADER_H__
+#define __PROJECT_AURORA_FRAME_PACER_HEADER_H__
+
+#include <chrono>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/types.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Keeps the frame rate at target_dt.
+
+	Precise mode: frames are scheduled on absolute deadlines, so errors
+	don't accumulate. The thread sleeps until a bit before the deadline
+	(clock_nanosleep with TIMER_ABSTIME on POSIX), and only spins for the
+	remaining time. The margin is the expected oversleep of the OS, and is
+	calibrated online from the measured oversleeps, so the spin is only a
+	few tens of microseconds on a quiet system.
+
+	Legacy mode: the old loop, a relative sleep of sleep_threshold followed
+	by a busy wait until target_dt. Kept for comparison.
+
+	Both modes collect the same statistics.
+*/
+
+class FramePacer
+{
+public:
+	enum class Mode : uint32_t {
+		Precise,
+		Legacy
+	};
+
+	struct Stats {
+		uint64_t n_frames = 0;
+		uint64_t n_late = 0; // frames that were already past the deadline
+		double sum_jitter = 0; // seconds, |wake up time - deadline|
+		double max_jitter = 0;
+		double sleep_time = 0; // seconds
+		double spin_time = 0;
+		double wait_cpu_time = 0; // cpu time of the calling thread while waiting
+	};
+
+	static constexpr ClockDuration min_margin = std::chrono::microseconds(20);
+	static constexpr ClockDuration max_margin = std::chrono::milliseconds(2);
+
+private:
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(Mode, mode)
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(ClockDuration, period)
+	MYLIB_OO_ENCAPSULATE_OBJ_READONLY(Stats, stats)
+
+	ClockTime deadline;
+	bool started = false;
+
+	// oversleep estimation, in seconds
+	float oversleep_mean = 0;
+	float oversleep_deviation = 0;
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(ClockDuration, margin, max_margin)
+
+	void wait_precise ();
+	void wait_legacy (const ClockTime& frame_begin);
+	void calibrate (const ClockDuration oversleep) noexcept;
+	void add_jitter (const ClockTime& wake_up, const ClockTime& deadline_) noexcept;
+
+public:
+	FramePacer (const Mode mode_, const float target_dt);
+
+	// blocks until the next frame must start
+	void wait (const ClockTime& frame_begin);
+
+	void report () const;
+};
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
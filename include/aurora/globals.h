@@ -6,6 +6,7 @@
 #endif
 
 #include <random>
+#include <chrono>
 
 #include <my-lib/event.h>
 #include <my-lib/event-timer.h>
@@ -21,18 +22,56 @@ namespace Game
 
 // ---------------------------------------------------
 
+class RenderBackend;
+class RenderPipeline;
+class ThreadPool;
+
+// ---------------------------------------------------
+
 inline MyGlib::Lib *game_lib = nullptr;
 inline MyGlib::Event::Manager *event_manager = nullptr;
 inline MyGlib::Audio::Manager *audio_manager = nullptr;
 inline MyGlib::Graphics::Manager *renderer = nullptr;
+inline RenderBackend *render_backend = nullptr;
+inline RenderPipeline *render_pipeline = nullptr;
+inline ThreadPool *thread_pool = nullptr;
 
 // ---------------------------------------------------
 
-inline std::mt19937_64 random_generator;
+/*
+	Time of the simulation, only advanced by the simulation steps.
+	Timers and coroutine waits run on it, so they stay consistent with the
+	simulation when frames are slowed down, and when the simulation runs
+	faster than real time.
+*/
+
+class SimulationClock
+{
+private:
+	ClockTime time = ClockTime();
+
+public:
+	ClockTime now () const noexcept
+	{
+		return this->time;
+	}
+
+	void advance (const float dt) noexcept
+	{
+		this->time += std::chrono::duration_cast<ClockDuration>(std::chrono::duration<float>(dt));
+	}
+};
+
+inline SimulationClock simulation_clock;
+
+inline ClockTime simulation_now () noexcept
+{
+	return simulation_clock.now();
+}
 
 // ---------------------------------------------------
 
-inline auto timer = Mylib::Event::make_timer<Coroutine>(Clock::now);
+inline auto timer = Mylib::Event::make_timer<Coroutine>(simulation_now);
 using Timer = decltype(timer);
 
 inline Mylib::InterpolationManager<Coroutine, float> interpolation_manager;
@@ -8,7 +8,13 @@
 #include <SDL.h>
 
 #include <vector>
+#include <array>
 #include <span>
+#include <map>
+#include <tuple>
+#include <memory>
+#include <algorithm>
+#include <utility>
 
 #include <my-lib/std.h>
 #include <my-lib/macros.h>
@@ -63,6 +69,70 @@ void load_graphics ();
 
 // ---------------------------------------------------
 
+/*
+	Sprite geometry is interned in the SpriteRegistry and referenced by id.
+	Entries are never moved nor freed, so render snapshots can reference
+	sprites by id even after the owner object was destroyed, and the render
+	thread can read them while the simulation thread registers new ones.
+	When a streamed texture finishes loading, the entries created with its
+	placeholder are retargeted to the loaded texture.
+*/
+
+class SpriteRegistry
+{
+public:
+	using Id = uint32_t;
+	using Vertices = std::array<GraphicsVertex, 6>; // 2 triangles
+
+	static constexpr uint32_t chunk_size = 1024;
+	static constexpr uint32_t max_chunks = 1024;
+
+private:
+	using Chunk = std::array<Vertices, chunk_size>;
+
+	// texture, size, source anchor, destination anchor
+	using Key = std::tuple<const void*, float, float, float, float, float, float, float>;
+
+	std::array<std::unique_ptr<Chunk>, max_chunks> chunks;
+	std::map<Key, Id> ids;
+	uint32_t n_entries = 0;
+
+	// placeholders that were replaced, since copies of them may still be interned
+	std::map<const void*, TextureDescriptor> aliases;
+
+	Vertices& get_mutable (const Id id) noexcept
+	{
+		return (*this->chunks[id / chunk_size])[id % chunk_size];
+	}
+
+public:
+	Id intern (const TextureDescriptor& texture, const Vector2 size, const Vector2 source_anchor, const Vector3& dest_anchor);
+
+	// Rebuilds every entry of texture "from" with texture "to".
+	// Must not be called while the render thread is building a frame.
+	void retarget (const TextureDescriptor& from, const TextureDescriptor& to);
+
+	const Vertices& get (const Id id) const noexcept
+	{
+		return (*this->chunks[id / chunk_size])[id % chunk_size];
+	}
+
+	// writes the sprite's 6 vertices placed at pos
+	void write_vertices (const Id id, GraphicsVertex *out, const Point& pos) const noexcept
+	{
+		const Vertices& vertices = this->get(id);
+
+		for (uint32_t i = 0; i < vertices.size(); i++) {
+			out[i] = vertices[i];
+			out[i].offset = pos;
+		}
+	}
+};
+
+inline SpriteRegistry sprite_registry;
+
+// ---------------------------------------------------
+
 class Sprite
 {
 public:
@@ -75,67 +145,176 @@ public:
 		WestNorthRepeat = 5
 	};
 
+	static constexpr uint32_t n_vertices = 6;
+
 private:
 	MYLIB_OO_ENCAPSULATE_PTR_INIT(StaticObject*, object, nullptr)
 	MYLIB_OO_ENCAPSULATE_OBJ(TextureDescriptor, texture)
-	//MYLIB_OO_ENCAPSULATE_OBJ_WITH_COPY_MOVE(Vector2, size)
-	//MYLIB_OO_ENCAPSULATE_OBJ_WITH_COPY_MOVE(Vector2, ds)
-
-	std::array<GraphicsVertex, 6> graphics_vertices; // 2 triangles
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(SpriteRegistry::Id, id)
 
 public:
 	Sprite (StaticObject *object_, const TextureDescriptor& texture_, const Vector2 size_, const Vector2 source_anchor_, const Vector3& dest_anchor_);
 
+	// uses a sprite already interned, the caller is responsible for hinting the texture streamer
+	Sprite (StaticObject *object_, const TextureDescriptor& texture_, const SpriteRegistry::Id id_);
+
+	// records the sprite at the owner object's position
 	void render ();
 };
 
 // ---------------------------------------------------
 
-class SpriteAnimation
+/*
+	Animations with the same frames and frame duration share an
+	AnimationTrack: the frames are interned once, and a single clock is
+	advanced once per frame by the AnimationTrackManager.
+	Each SpriteAnimation only keeps a reference to its track and a phase
+	offset relative to the track's clock.
+	Tracks are reference counted, and dropped by the manager once unused.
+*/
+
+class AnimationTrack
+{
+private:
+	MYLIB_OO_ENCAPSULATE_OBJ_READONLY(std::vector<SpriteRegistry::Id>, frames)
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(float, frame_duration)
+
+	// frames elapsed since the track was created
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint64_t, tick, 0)
+
+	float current_frame_time = 0;
+	uint32_t n_users = 0;
+
+	friend class AnimationTrackManager;
+
+public:
+	AnimationTrack (std::vector<SpriteRegistry::Id> frames_, const float frame_duration_)
+		: frames(std::move(frames_)), frame_duration(frame_duration_)
+	{
+	}
+
+	uint32_t get_n_frames () const noexcept
+	{
+		return this->frames.size();
+	}
+
+	void advance (const float dt) noexcept;
+};
+
+// ---------------------------------------------------
+
+class AnimationTrackManager
 {
+private:
+	using Key = std::pair<std::vector<SpriteRegistry::Id>, float>;
+
+	// std::map never invalidates pointers to its elements
+	std::map<Key, AnimationTrack> tracks;
+
 public:
-	using Event = FooEvent;
-	using EventHandler = Mylib::Event::Handler<Event>;
+	// every acquire must be paired with a release
+	AnimationTrack* acquire (std::vector<SpriteRegistry::Id> frames, const float frame_duration);
+
+	void release (AnimationTrack *track) noexcept
+	{
+		track->n_users--;
+	}
+
+	// advances the tracks in use, and drops the unused ones
+	void process (const float dt) noexcept;
+};
 
+inline AnimationTrackManager animation_track_manager;
+
+// ---------------------------------------------------
+
+class SpriteAnimation
+{
 private:
 	MYLIB_OO_ENCAPSULATE_PTR_INIT(StaticObject*, object, nullptr)
-	MYLIB_OO_ENCAPSULATE_OBJ_READONLY(std::vector<Sprite>, sprites)
-	MYLIB_OO_ENCAPSULATE_SCALAR(float, frame_duration)
-	MYLIB_OO_ENCAPSULATE_SCALAR_INIT(uint32_t, current_frame, 0)
-	MYLIB_OO_ENCAPSULATE_SCALAR_INIT(float, current_frame_time, 0)
-	MYLIB_OO_ENCAPSULATE_OBJ(EventHandler, event_handler)
+
+	AnimationTrack *track = nullptr;
+
+	/*
+		Running: offset of the animation's frame relative to the track's frame.
+		Stopped: the frozen frame.
+	*/
+	uint64_t phase = 0;
 
 	bool stopped = false;
-	
+
+	uint32_t get_running_frame () const noexcept
+	{
+		return (this->track->get_tick() + this->phase) % this->track->get_n_frames();
+	}
+
+	void set_running_frame (const uint32_t frame) noexcept
+	{
+		const uint64_t tick = this->track->get_tick();
+		const uint32_t n = this->track->get_n_frames();
+
+		this->phase = (frame + n - (tick % n)) % n;
+	}
+
+	void release () noexcept
+	{
+		if (this->track != nullptr)
+			animation_track_manager.release(this->track);
+		this->track = nullptr;
+	}
 
 public:
 	SpriteAnimation () = default;
 	SpriteAnimation (StaticObject *object_, std::span<TextureDescriptor> textures, const Vector2 size_, const Vector2 source_anchor_, const Vector3& dest_anchor_, const float frame_duration_);
 
+	~SpriteAnimation ()
+	{
+		this->release();
+	}
+
 	// delete copy constructor and assignment operator
 	SpriteAnimation (const SpriteAnimation&) = delete;
 	SpriteAnimation& operator= (const SpriteAnimation&) = delete;
 
-	// provide default move construtor and assignment operator
-	SpriteAnimation (SpriteAnimation&&) = default;
-	SpriteAnimation& operator= (SpriteAnimation&&) = default;
+	// the moved-from animation gives its track reference away
+	SpriteAnimation (SpriteAnimation&& other) noexcept;
+	SpriteAnimation& operator= (SpriteAnimation&& other) noexcept;
 
 	void render (const float dt);
 
+	float get_frame_duration () const noexcept
+	{
+		return this->track->get_frame_duration();
+	}
+
+	// moves the animation to the track of the new duration, keeping its current frame
+	void set_frame_duration (const float frame_duration);
+
+	uint32_t get_current_frame () const noexcept
+	{
+		return this->stopped ? static_cast<uint32_t>(this->phase) : this->get_running_frame();
+	}
+
 	void play () noexcept
 	{
+		if (this->stopped)
+			this->set_running_frame(this->phase);
 		this->stopped = false;
 	}
 	
 	void stop () noexcept
 	{
+		if (!this->stopped)
+			this->phase = this->get_running_frame();
 		this->stopped = true;
 	}
 
 	void reset () noexcept
 	{
-		this->current_frame = 0;
-		this->current_frame_time = 0;
+		if (this->stopped)
+			this->phase = 0;
+		else
+			this->set_running_frame(0);
 	}
 };
 
@@ -193,6 +372,30 @@ public:
 
 // ---------------------------------------------------
 
+/*
+	Rotating cubes (e.g., spells) are recorded as small instances and
+	submitted together in the frame's batched color buffer, so we never
+	rebuild nor draw a Cube3D per instance.
+	The batching only saves submission work: my-game-lib's color program
+	has no per-instance transform, so the rotation and the 36 vertices of
+	each cube are still computed on the CPU, by the render workers.
+*/
+
+struct CubeInstance {
+	Point previous_pos;
+	Point pos;
+	Vector axis; // must be normalized
+	float angle;
+	float size;
+	Color color;
+};
+
+inline constexpr uint32_t n_vertices_per_cube = 36;
+
+void write_cube_vertices (const CubeInstance& instance, const float alpha, ColorVertex *out) noexcept;
+
+// ---------------------------------------------------
+
 } // end namespace Game
 
 #endif
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef __PROJECT_AURORA_INPUT_HEADER_H__
+#define __PROJECT_AURORA_INPUT_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <SDL.h>
+
+#include <array>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/types.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Movement keys are recorded by an SDL event watch, which SDL calls from
+	SDL_PumpEvents, i.e., inside event_manager->process_events() on the
+	main thread. The main loop pumps right before the simulation, so the
+	frame uses the most recent input possible.
+	Events reach the game only when the main loop pumps, so an input waits
+	up to one pump interval (about a frame) in the OS queue before SDL
+	receives and timestamps it. The latency reported is measured from
+	SDL's timestamp to the presentation of the first frame that used the
+	input, and the pump interval is reported alongside it: the real
+	input-to-present latency is bounded by their sum.
+*/
+
+class InputSampler
+{
+public:
+	// keys the simulation polls, as bits of get_keys()
+	enum Key : uint32_t {
+		Up    = 1 << 0,
+		Down  = 1 << 1,
+		Left  = 1 << 2,
+		Right = 1 << 3
+	};
+
+	struct Stats {
+		uint64_t n_events = 0;
+		uint64_t n_samples = 0; // presented frames that used new input
+		double sum_latency = 0; // seconds
+		double max_latency = 0;
+		uint64_t n_pumps = 0;
+		double sum_pump_interval = 0; // seconds
+		double max_pump_interval = 0;
+	};
+
+private:
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint32_t, keys, 0)
+	MYLIB_OO_ENCAPSULATE_OBJ_READONLY(Stats, stats)
+
+	// input recorded by the event watch since the last sample
+	ClockTime oldest_event_time = ClockTime::max();
+	bool has_new_input = false;
+
+	ClockTime last_sample_time;
+	bool has_sampled = false;
+
+	// oldest input used by the frames not presented yet, indexed by the frame's age
+	std::array<ClockTime, 2> pending_input_time;
+	std::array<bool, 2> has_pending_input = { false, false };
+
+	static int event_watch (void *userdata, SDL_Event *event);
+
+public:
+	void start ();
+	void stop ();
+
+	// must be called once per frame, right after event_manager->process_events()
+	void sample ();
+
+	// must be called right after the frame is presented
+	void frame_presented ();
+
+	void report () const;
+};
+
+inline InputSampler input_sampler;
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
@@ -6,6 +6,8 @@
 #endif
 
 #include <chrono>
+#include <span>
+#include <cstddef>
 
 #include <SDL.h>
 
@@ -17,6 +19,7 @@
 
 #include <aurora/types.h>
 #include <aurora/globals.h>
+#include <aurora/random.h>
 
 
 namespace Game
@@ -40,24 +43,54 @@ constexpr float ClockDuration_to_float (const ClockDuration& d)
 
 // ---------------------------------------------------
 
+// FNV-1a, used to check whether baked asset files are up to date with their sources
+
+constexpr uint64_t hash_fnv1a (const std::span<const std::byte> data, uint64_t hash = 0xCBF29CE484222325) noexcept
+{
+	for (const std::byte b : data) {
+		hash ^= static_cast<uint64_t>(b);
+		hash *= 0x100000001B3;
+	}
+
+	return hash;
+}
+
+// ---------------------------------------------------
+
+// The versions without a generator use the gameplay stream, so they must only be called from the main thread.
+
+inline RandomGenerator& gameplay_random () noexcept
+{
+	return random_service.get_stream(RandomService::System::Gameplay);
+}
+
 template <typename T>
-T random_vector ()
+T random_vector (RandomGenerator& gen)
 {
 	T r;
-	std::uniform_real_distribution<typename T::Type> d(0, 1);
 
 	for (uint32_t i = 0; i < T::get_dim(); i++)
-		r[i] = d(random_generator);
+		r[i] = gen.next_float();
 
 	return r;
 }
 
+template <typename T>
+T random_vector ()
+{
+	return random_vector<T>( gameplay_random() );
+}
+
 // ---------------------------------------------------
 
+inline float random_float (RandomGenerator& gen, const float min, const float max)
+{
+	return gen.next_float(min, max);
+}
+
 inline float random_float (const float min, const float max)
 {
-	std::uniform_real_distribution<float> d(min, max);
-	return d(random_generator);
+	return random_float(gameplay_random(), min, max);
 }
 
 // ---------------------------------------------------
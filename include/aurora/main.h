@@ -7,6 +7,8 @@
 
 #include <my-game-lib/my-game-lib.h>
 
+#include <aurora/frame-pacer.h>
+
 
 namespace Game
 {
@@ -24,6 +26,9 @@ public:
 		uint32_t window_width_px;
 		uint32_t window_height_px;
 		bool fullscreen;
+		bool headless; // no GPU work, see NullRenderBackend
+		bool fast_forward; // frames are not paced and each one simulates target_dt, faster than real time
+		uint32_t max_frames; // 0 means run until the user quits
 	};
 
 	enum class State {
@@ -36,6 +41,14 @@ protected:
 	MYLIB_OO_ENCAPSULATE_SCALAR(bool, alive)
 	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(State, state)
 	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(InitConfig, cfg_params)
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint64_t, n_frames, 0)
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint64_t, n_simulation_steps, 0)
+
+	// after Config::heap_stats_warmup_frames
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint64_t, n_steady_heap_allocations, 0)
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint64_t, n_steady_frames_allocating, 0)
+
+	FramePacer frame_pacer;
 
 	MyGlib::Event::Quit::Descriptor event_quit_d;
 	MyGlib::Event::KeyDown::Descriptor event_key_down_d;
@@ -46,6 +59,8 @@ private:
 	Main (const InitConfig& cfg);
 	~Main ();
 
+	void simulation_step (const float dt);
+
 public:
 	void run ();
 	void event_quit (const MyGlib::Event::Quit::Type);
@@ -0,0 +1,64 @@
+#ifndef __PROJECT_AURORA_MAPPED_FILE_HEADER_H__
+#define __PROJECT_AURORA_MAPPED_FILE_HEADER_H__
+
+#include <span>
+#include <memory>
+#include <cstddef>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/types.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Read-only view of a whole file.
+	On POSIX systems the file is memory-mapped, so nothing is read from
+	disk until the data is accessed, and pages are shared by the page cache.
+	The mapping is private (copy-on-write), so callers that expect writable
+	buffers (e.g., SDL surfaces) can point into it without modifying the file.
+	On other systems the file is read into memory.
+*/
+
+class MappedFile
+{
+private:
+	std::byte *data = nullptr;
+	size_t size = 0;
+
+#if !defined(__unix__) && !defined(__APPLE__)
+	std::unique_ptr<std::byte[]> storage;
+#endif
+
+public:
+	MappedFile () = default;
+	~MappedFile ();
+
+	MappedFile (const MappedFile&) = delete;
+	MappedFile& operator= (const MappedFile&) = delete;
+
+	// returns false if the file doesn't exist or can't be read
+	bool open (const char *fname);
+	void close ();
+
+	bool is_open () const noexcept
+	{
+		return (this->data != nullptr);
+	}
+
+	std::span<std::byte> get_data () const noexcept
+	{
+		return std::span<std::byte>(this->data, this->size);
+	}
+};
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
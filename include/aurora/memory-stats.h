@@ -0,0 +1,24 @@
+#ifndef __PROJECT_AURORA_MEMORY_STATS_HEADER_H__
+#define __PROJECT_AURORA_MEMORY_STATS_HEADER_H__
+
+#include <cstdint>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Number of calls to the global operator new since the program started,
+	from all threads.
+	Used to check that the steady-state game loop doesn't allocate memory.
+*/
+
+uint64_t get_n_heap_allocations () noexcept;
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
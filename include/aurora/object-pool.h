@@ -0,0 +1,124 @@
+#ifndef __PROJECT_AURORA_OBJECT_POOL_HEADER_H__
+#define __PROJECT_AURORA_OBJECT_POOL_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <new>
+
+#include <cstddef>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/object.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Pool of objects of type T.
+	Memory is allocated in chunks that are never freed nor moved, objects
+	are constructed in place, and their memory is recycled when the World
+	destroys them (see ObjectDeleter).
+	Once the pool is big enough for the game's peak, spawning and
+	destroying objects doesn't touch the heap.
+	Must only be used by the simulation thread.
+*/
+
+template <typename T>
+class ObjectPool : public ObjectPoolBase
+{
+private:
+	struct alignas(T) Slot {
+		std::byte data[sizeof(T)];
+	};
+
+	std::vector< std::unique_ptr<Slot[]> > chunks;
+	std::vector<Slot*> free_slots;
+	uint32_t capacity = 0;
+
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint32_t, n_alive, 0)
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint64_t, n_constructed, 0)
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint32_t, n_chunk_allocations, 0)
+
+	void grow (const uint32_t chunk_size = Config::object_pool_chunk_size)
+	{
+		this->chunks.push_back( std::make_unique<Slot[]>(chunk_size) );
+		this->n_chunk_allocations++;
+		this->capacity += chunk_size;
+
+		// recycle() pushes without allocating
+		this->free_slots.reserve(this->capacity);
+
+		Slot *chunk = this->chunks.back().get();
+
+		// reversed, so the first objects are constructed at the beginning of the chunk
+		for (uint32_t i = chunk_size; i > 0; i--)
+			this->free_slots.push_back(chunk + (i - 1));
+	}
+
+public:
+	ObjectPool (const uint32_t initial_capacity = Config::object_pool_chunk_size)
+	{
+		while (this->capacity < initial_capacity)
+			this->grow();
+	}
+
+	// all objects must have been recycled
+	~ObjectPool () = default;
+
+	ObjectPool (const ObjectPool&) = delete;
+	ObjectPool& operator= (const ObjectPool&) = delete;
+
+	// makes room for n more objects with a single chunk allocation
+	void reserve (const uint32_t n)
+	{
+		if (this->free_slots.size() < n)
+			this->grow(n - this->free_slots.size());
+	}
+
+	template <typename... Args>
+	T* construct (Args&&... args)
+	{
+		if (this->free_slots.empty()) [[unlikely]]
+			this->grow();
+
+		Slot *slot = this->free_slots.back();
+
+		T *obj = new (slot->data) T(std::forward<Args>(args)...);
+		obj->set_pool(this);
+
+		// only after the constructor succeeded
+		this->free_slots.pop_back();
+
+		this->n_alive++;
+		this->n_constructed++;
+
+		return obj;
+	}
+
+	void recycle (Object *obj) noexcept override
+	{
+		T *t = static_cast<T*>(obj);
+		t->~T();
+
+		this->free_slots.push_back( reinterpret_cast<Slot*>(t) );
+		this->n_alive--;
+	}
+};
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
@@ -8,10 +8,11 @@
 #include <SDL.h>
 
 #include <string>
-#include <list>
 #include <memory>
 #include <initializer_list>
 
+#include <boost/container/static_vector.hpp>
+
 #include <my-lib/std.h>
 #include <my-lib/macros.h>
 #include <my-lib/coroutine.h>
@@ -23,6 +24,7 @@
 #include <aurora/types.h>
 #include <aurora/graphics.h>
 #include <aurora/collision.h>
+#include <aurora/slot-map.h>
 
 
 namespace Game
@@ -31,6 +33,59 @@ namespace Game
 // ---------------------------------------------------
 
 class World;
+class Object;
+
+// ---------------------------------------------------
+
+// see ObjectPool
+
+class ObjectPoolBase
+{
+public:
+	// destroys the object and keeps its memory for the next one
+	virtual void recycle (Object *obj) noexcept = 0;
+};
+
+// ---------------------------------------------------
+
+/*
+	Deleter of the objects owned by the World.
+	Objects that came from a pool go back to it, the others are deleted.
+*/
+
+struct ObjectDeleter {
+	void operator() (Object *obj) const noexcept;
+};
+
+// ---------------------------------------------------
+
+/*
+	Storage kind of an object, resolved once at construction by the
+	constructors of StaticObject and DynamicObject.
+	The World keeps one bucket per kind, so it never has to discover the
+	kind of an object with dynamic_cast.
+*/
+
+enum class ObjectKind : uint32_t {
+	None,     // not stored in the World (e.g., the map)
+	Static,
+	Dynamic
+};
+
+// ---------------------------------------------------
+
+/*
+	Handle to an object stored in the World.
+	Unlike a raw pointer, it can be safely checked with World::get_object
+	after the object was destroyed.
+*/
+
+struct ObjectHandle {
+	ObjectKind kind = ObjectKind::None;
+	SlotHandle slot;
+
+	bool operator== (const ObjectHandle&) const noexcept = default;
+};
 
 // ---------------------------------------------------
 
@@ -42,8 +97,7 @@ public:
 		_MYLIB_ENUM_CLASS_OBJECT_TYPE_VALUE_(Tree) \
 		_MYLIB_ENUM_CLASS_OBJECT_TYPE_VALUE_(Castle) \
 		_MYLIB_ENUM_CLASS_OBJECT_TYPE_VALUE_(Character) \
-		_MYLIB_ENUM_CLASS_OBJECT_TYPE_VALUE_(Spell) \
-		_MYLIB_ENUM_CLASS_OBJECT_TYPE_VALUE_(VisualEffect)
+		_MYLIB_ENUM_CLASS_OBJECT_TYPE_VALUE_(Spell)
 
 	enum class Type : uint32_t {
 		#define _MYLIB_ENUM_CLASS_OBJECT_TYPE_VALUE_(V) V,
@@ -59,8 +113,7 @@ public:
 		_MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(Castle, Castle_00) \
 		_MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(Character, Player) \
 		_MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(Character, Enemy) \
-		_MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(Spell, Spell) \
-		_MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(VisualEffect, Explosion)
+		_MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(Spell, Spell)
 
 	enum class Subtype : uint32_t {
 		#define _MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(TYPE, V) V,
@@ -68,6 +121,12 @@ public:
 		#undef _MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_
 	};
 
+	static constexpr uint32_t n_subtypes = 0
+		#define _MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(TYPE, V) + 1
+		_MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUES_
+		#undef _MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_
+		;
+
 	#define _MYLIB_ENUM_CLASS_OBJECT_DIRECTION_VALUES_ \
 		_MYLIB_ENUM_CLASS_OBJECT_DIRECTION_VALUE_(South) \
 		_MYLIB_ENUM_CLASS_OBJECT_DIRECTION_VALUE_(SouthWest) \
@@ -112,11 +171,21 @@ protected:
 	MYLIB_OO_ENCAPSULATE_PTR(World*, world)
 	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(Type, type)
 	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(Subtype, subtype)
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(ObjectKind, kind)
 	MYLIB_OO_ENCAPSULATE_OBJ_WITH_COPY_MOVE(std::string, name)
 
+	// assigned by the World when the object is added
+	MYLIB_OO_ENCAPSULATE_OBJ_WITH_COPY_MOVE(ObjectHandle, handle)
+
+	// set by World::remove_object_next_frame, so removal requests are only queued once
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT(bool, removal_pending, false)
+
+	// pool that owns the object's memory, nullptr for heap allocated objects
+	MYLIB_OO_ENCAPSULATE_PTR_INIT(ObjectPoolBase*, pool, nullptr)
+
 public:
-	inline Object (World *world_, const Subtype subtype_)
-		: world(world_), type(get_type(subtype_)), subtype(subtype_)
+	inline Object (World *world_, const Subtype subtype_, const ObjectKind kind_ = ObjectKind::None)
+		: world(world_), type(get_type(subtype_)), subtype(subtype_), kind(kind_)
 	{
 	}
 
@@ -133,17 +202,21 @@ class StaticObject : public Object
 {
 	MYLIB_OO_ENCAPSULATE_OBJ_INIT_WITH_COPY_MOVE(Point, pos, Point::zero())
 
+	// position at the previous simulation step, used to interpolate rendering
+	MYLIB_OO_ENCAPSULATE_OBJ_INIT_WITH_COPY_MOVE(Point, previous_pos, Point::zero())
+
 protected:
-	std::list<Collider> colliders;
+	// must not be erased from, since the world keeps pointers to them
+	boost::container::static_vector<Collider, Config::max_colliders_per_object> colliders;
 
 public:
-	inline StaticObject (World *world_, const Subtype subtype_)
-		: Object(world_, subtype_)
+	inline StaticObject (World *world_, const Subtype subtype_, const ObjectKind kind_ = ObjectKind::Static)
+		: Object(world_, subtype_, kind_)
 	{
 	}
 
-	inline StaticObject (World *world_, const Subtype subtype_, const Point& pos_)
-		: Object(world_, subtype_), pos(pos_)
+	inline StaticObject (World *world_, const Subtype subtype_, const Point& pos_, const ObjectKind kind_ = ObjectKind::Static)
+		: Object(world_, subtype_, kind_), pos(pos_), previous_pos(pos_)
 	{
 	}
 
@@ -152,9 +225,12 @@ public:
 		return this->colliders;
 	}
 
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
+	inline void store_previous_state () noexcept
+	{
+		this->previous_pos = this->pos;
+	}
+
 	void render_colliders (const Color& color) const;
-#endif
 };
 
 // ---------------------------------------------------
@@ -170,19 +246,12 @@ public:
 	{
 	}
 
-	void render (const float dt) override final;
-};
-
-// ---------------------------------------------------
-
-class StaticObjectAnimation : public StaticObject
-{
-	MYLIB_OO_ENCAPSULATE_OBJ(SpriteAnimation, animation)
-	SpriteAnimation::EventHandler::Descriptor animation_event_descriptor;
-
-public:
-	StaticObjectAnimation (World *world_, const Subtype subtype_, const Point& pos_, const std::span<TextureDescriptor> textures_, const Vector2& size_, const Vector2 source_anchor_, const Vector3 dest_anchor_, const float frame_duration_, const bool die_after_animation);
-	~StaticObjectAnimation ();
+	// see Sprite's constructors
+	StaticObjectSprite (World *world_, const Subtype subtype_, const Point& pos_, const TextureDescriptor& texture_, const SpriteRegistry::Id sprite_id_)
+		: StaticObject(world_, subtype_, pos_),
+		  sprite(this, texture_, sprite_id_)
+	{
+	}
 
 	void render (const float dt) override final;
 };
@@ -196,15 +265,15 @@ protected:
 
 public:
 	inline DynamicObject (World *world_, const Subtype subtype_)
-		: StaticObject(world_, subtype_)
+		: StaticObject(world_, subtype_, ObjectKind::Dynamic)
 	{
 	}
 
 	inline DynamicObject (World *world_, const Subtype subtype_, const Point& pos_)
-		: StaticObject(world_, subtype_, pos_)
+		: StaticObject(world_, subtype_, pos_, ObjectKind::Dynamic)
 	{
 	}
-	
+
 	inline void physics (const float dt) noexcept
 	{
 		this->pos += this->vel * dt + Config::gravity * dt * dt / fp(2);
@@ -236,12 +305,13 @@ public:
 class EnemyObject : public DynamicObject
 {
 private:
+	boost::container::static_vector<Point2, 8> patrol;
+	uint32_t patrol_leg = 0;    // the enemy walks from patrol[patrol_leg] to the next point
+	float patrol_elapsed = 0;   // since the current leg started
 	Sprite sprite;
-	Coroutine coroutine;
 	
 public:
 	EnemyObject (World *world_, const std::initializer_list<Point2> positions);
-	~EnemyObject ();
 
 	void render (const float dt) override final;
 	void update (const float dt) override final;
@@ -253,16 +323,14 @@ public:
 class SpellObject : public DynamicObject
 {
 private:
-	Cube3D cube;
 	Color color;
 	Mylib::LinearInterpolator<float, Color> color_interpolator;
 	Vector axis;
 	float angle;
-	Timer::Descriptor timer_descriptor;
+	float age = 0;
 
 public:
 	SpellObject (World *world_, const Point& pos_, const Vector& direction_);
-	~SpellObject ();
 
 	void render (const float dt) override final;
 	void update (const float dt) override final;
@@ -278,12 +346,6 @@ std::unique_ptr<StaticObjectSprite> build_static_object_sprite (
 	const Vector& pos
 	);
 
-std::unique_ptr<StaticObjectAnimation> build_static_object_animation (
-	World *world,
-	const Object::Subtype subtype,
-	const Vector& pos
-	);
-
 // ---------------------------------------------------
 
 const char* enum_class_to_str (const Object::Type value);
@@ -0,0 +1,76 @@
+#ifndef __PROJECT_AURORA_PHYSICS_HEADER_H__
+#define __PROJECT_AURORA_PHYSICS_HEADER_H__
+
+#include <vector>
+
+#include <my-lib/std.h>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/simd.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+struct ColliderBox {
+	Vec4 center;
+	Vec4 half_size;
+};
+
+// ---------------------------------------------------
+
+/*
+	Sweep-and-prune broadphase on the x axis.
+	The boxes are sorted by their lowest x, so each box is only paired with
+	the boxes whose x interval starts before its own ends, instead of with
+	every other box.
+	For colliders spread over the map, this is close to linear in the
+	number of colliders, while testing every pair is quadratic.
+*/
+
+struct BroadphaseBox {
+	float min_x;
+	float max_x;
+	uint32_t id;
+};
+
+struct BroadphasePair {
+	uint32_t a;
+	uint32_t b;
+};
+
+// sorts the boxes, and appends to pairs the ids of every two boxes whose x intervals overlap
+void sweep_and_prune (std::vector<BroadphaseBox>& boxes, std::vector<BroadphasePair>& pairs);
+
+// ---------------------------------------------------
+
+/*
+	Same as check_collision(), but on boxes.
+	Returns true if the boxes are colliding, and ds is the displacement
+	box b should move to stop colliding.
+*/
+
+inline bool test_collision (const ColliderBox& a, const ColliderBox& b, Vec4& ds) noexcept
+{
+	const Vec4 distance = b.center - a.center;
+	const Vec4 target_distance = a.half_size + b.half_size;
+	const Vec4 abs_distance = distance.abs();
+
+	ds = Vec4::copysign(target_distance - abs_distance, distance);
+
+	// only x, y and z matter
+	return (Vec4::less_mask(abs_distance, target_distance) & 0b111) == 0b111;
+}
+
+// ---------------------------------------------------
+
+void run_physics_benchmark (const uint32_t n_objects, const uint32_t n_iterations);
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef __PROJECT_AURORA_RANDOM_HEADER_H__
+#define __PROJECT_AURORA_RANDOM_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <array>
+#include <span>
+#include <limits>
+#include <utility>
+
+#include <cstdint>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/types.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	xoshiro256** generator, by Blackman and Vigna.
+	32 bytes of state, a handful of instructions per number, and jump
+	functions that split the sequence into non-overlapping streams.
+	It satisfies UniformRandomBitGenerator, so it can also be used with the
+	std distributions and with my-game-lib's Colors::random.
+	A generator must only be used by one thread at a time.
+*/
+
+class RandomGenerator
+{
+public:
+	using result_type = uint64_t;
+
+private:
+	std::array<uint64_t, 4> s;
+
+	static constexpr uint64_t rotl (const uint64_t x, const int k) noexcept
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+
+	void jump (const std::array<uint64_t, 4>& polynomial) noexcept;
+
+public:
+	// state is expanded from the seed with splitmix64, so any seed is fine
+	explicit RandomGenerator (uint64_t seed = 0) noexcept;
+
+	static constexpr result_type min () noexcept
+	{
+		return 0;
+	}
+
+	static constexpr result_type max () noexcept
+	{
+		return std::numeric_limits<result_type>::max();
+	}
+
+	result_type operator() () noexcept
+	{
+		const uint64_t result = rotl(this->s[1] * 5, 7) * 9;
+		const uint64_t t = this->s[1] << 17;
+
+		this->s[2] ^= this->s[0];
+		this->s[3] ^= this->s[1];
+		this->s[1] ^= this->s[2];
+		this->s[0] ^= this->s[3];
+		this->s[2] ^= t;
+		this->s[3] = rotl(this->s[3], 45);
+
+		return result;
+	}
+
+	// advances 2^128 numbers
+	void jump () noexcept;
+
+	// advances 2^192 numbers
+	void long_jump () noexcept;
+
+	// uniform in [0, 1), from the upper 24 bits
+	float next_float () noexcept
+	{
+		return static_cast<float>((*this)() >> 40) * 0x1.0p-24f;
+	}
+
+	// uniform in [min, max)
+	float next_float (const float min, const float max) noexcept
+	{
+		return min + (max - min) * this->next_float();
+	}
+
+	void fill_floats (const std::span<float> out, const float min, const float max) noexcept;
+
+	// each component is uniform in [min[i], max[i])
+	template <typename T>
+	void fill_vectors (const std::span<T> out, const T& min, const T& max) noexcept
+	{
+		const T range = max - min;
+
+		for (T& v : out) {
+			for (uint32_t i = 0; i < T::get_dim(); i++)
+				v[i] = min[i] + range[i] * this->next_float();
+		}
+	}
+};
+
+// ---------------------------------------------------
+
+/*
+	Hands out independent, reproducible streams of a single seed.
+	Each system owns the stream long_jump'ed (system + 1) times from the
+	seed, and sub-stream i of a system is that stream jump'ed i times.
+	Parallel jobs should index the sub-streams by task instead of by
+	worker thread, so the numbers don't depend on scheduling.
+*/
+
+class RandomService
+{
+public:
+	enum class System : uint32_t {
+		Gameplay,
+		Effects,
+		Benchmark
+	};
+
+	static constexpr uint32_t n_systems = std::to_underlying(System::Benchmark) + 1;
+
+private:
+	MYLIB_OO_ENCAPSULATE_SCALAR_READONLY(uint64_t, seed)
+
+	// main thread streams of each system
+	std::array<RandomGenerator, n_systems> streams;
+
+public:
+	RandomService (const uint64_t seed_ = 0) noexcept
+	{
+		this->set_seed(seed_);
+	}
+
+	void set_seed (const uint64_t seed_) noexcept;
+
+	RandomGenerator make_stream (const System system, const uint32_t sub_stream = 0) const noexcept;
+
+	RandomGenerator& get_stream (const System system) noexcept
+	{
+		return this->streams[ std::to_underlying(system) ];
+	}
+};
+
+inline RandomService random_service;
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
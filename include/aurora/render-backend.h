@@ -0,0 +1,170 @@
+#ifndef __PROJECT_AURORA_RENDER_BACKEND_HEADER_H__
+#define __PROJECT_AURORA_RENDER_BACKEND_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <SDL.h>
+
+#include <vector>
+#include <deque>
+#include <span>
+#include <type_traits>
+
+#include <cstddef>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+#include <my-lib/matrix.h>
+
+#include <my-game-lib/my-game-lib.h>
+
+#include <aurora/types.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+// texture coordinates of the corners of a texture, z is the atlas layer
+
+struct TextureCoords {
+	Vector left_bottom;
+	Vector right_bottom;
+	Vector left_top;
+	Vector right_top;
+};
+
+// ---------------------------------------------------
+
+/*
+	Every graphics operation the game performs goes through the backend.
+	The OpenGL backend forwards to my-game-lib's renderer.
+	The null backend does no GPU work at all and only counts what would be
+	drawn, so the CPU side of the game can be benchmarked without a GPU.
+*/
+
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend () = default;
+
+	virtual void begin_texture_loading () = 0;
+	virtual TextureDescriptor load_texture (const char *fname) = 0;
+
+	// packs an already decoded image into the atlas, the surface is not freed
+	virtual TextureDescriptor load_texture (SDL_Surface *surface) = 0;
+
+	virtual void end_texture_loading () = 0;
+	virtual Mylib::Matrix<TextureDescriptor> split_texture (const TextureDescriptor& texture, const uint32_t nrows, const uint32_t ncols) = 0;
+	virtual TextureCoords get_texture_coords (const TextureDescriptor& texture) = 0;
+
+	virtual LightPointDescriptor add_light_point_source (const Point& pos, const Color& color) = 0;
+
+	virtual void setup_render_3D (const MyGlib::Graphics::RenderArgs3D& args) = 0;
+	virtual std::span<GraphicsVertex> alloc_triangles_texture (const uint32_t n_vertices) = 0;
+	virtual std::span<ColorVertex> alloc_triangles_color (const uint32_t n_vertices) = 0;
+	virtual std::span<LineVertex> alloc_lines (const uint32_t n_vertices) = 0;
+
+	virtual void wait_next_frame () = 0;
+	virtual void render () = 0;
+	virtual void update_screen () = 0;
+};
+
+// ---------------------------------------------------
+
+class OpenglRenderBackend : public RenderBackend
+{
+private:
+	MyGlib::Graphics::Opengl::Renderer *opengl_renderer;
+
+public:
+	OpenglRenderBackend (MyGlib::Graphics::Manager *renderer_);
+
+	void begin_texture_loading () override final;
+	TextureDescriptor load_texture (const char *fname) override final;
+	TextureDescriptor load_texture (SDL_Surface *surface) override final;
+	void end_texture_loading () override final;
+	Mylib::Matrix<TextureDescriptor> split_texture (const TextureDescriptor& texture, const uint32_t nrows, const uint32_t ncols) override final;
+	TextureCoords get_texture_coords (const TextureDescriptor& texture) override final;
+
+	LightPointDescriptor add_light_point_source (const Point& pos, const Color& color) override final;
+
+	void setup_render_3D (const MyGlib::Graphics::RenderArgs3D& args) override final;
+	std::span<GraphicsVertex> alloc_triangles_texture (const uint32_t n_vertices) override final;
+	std::span<ColorVertex> alloc_triangles_color (const uint32_t n_vertices) override final;
+	std::span<LineVertex> alloc_lines (const uint32_t n_vertices) override final;
+
+	void wait_next_frame () override final;
+	void render () override final;
+	void update_screen () override final;
+};
+
+// ---------------------------------------------------
+
+class NullRenderBackend : public RenderBackend
+{
+public:
+	struct Stats {
+		uint64_t n_frames = 0;
+		uint64_t n_textures = 0;
+		uint64_t n_draws = 0; // vertex allocations, each one would be a draw call
+		uint64_t n_vertices = 0;
+		uint64_t n_bytes = 0;
+	};
+
+private:
+	MYLIB_OO_ENCAPSULATE_OBJ_READONLY(Stats, stats)
+
+	// scratch memory the game writes its vertices into, reused every frame
+	std::vector<GraphicsVertex> triangles_texture;
+	std::vector<ColorVertex> triangles_color;
+	std::vector<LineVertex> lines;
+
+	/*
+		Each texture gets its own info address, so that the sprite registry
+		and the texture streamer, which key textures by info, see distinct
+		textures as in a real run.
+		The infos are never dereferenced, so they are just uninitialized
+		storage with stable addresses.
+	*/
+	using TextureInfo = std::remove_pointer_t<decltype(TextureDescriptor::info)>;
+
+	struct alignas(TextureInfo) FakeTextureInfo {
+		std::byte storage[sizeof(TextureInfo)];
+	};
+
+	std::deque<FakeTextureInfo> fake_texture_infos;
+
+	TextureDescriptor make_texture ();
+
+	template <typename Vertex>
+	std::span<Vertex> alloc (std::vector<Vertex>& storage, const uint32_t n_vertices);
+
+public:
+	void begin_texture_loading () override final;
+	TextureDescriptor load_texture (const char *fname) override final;
+	TextureDescriptor load_texture (SDL_Surface *surface) override final;
+	void end_texture_loading () override final;
+	Mylib::Matrix<TextureDescriptor> split_texture (const TextureDescriptor& texture, const uint32_t nrows, const uint32_t ncols) override final;
+	TextureCoords get_texture_coords (const TextureDescriptor& texture) override final;
+
+	LightPointDescriptor add_light_point_source (const Point& pos, const Color& color) override final;
+
+	void setup_render_3D (const MyGlib::Graphics::RenderArgs3D& args) override final;
+	std::span<GraphicsVertex> alloc_triangles_texture (const uint32_t n_vertices) override final;
+	std::span<ColorVertex> alloc_triangles_color (const uint32_t n_vertices) override final;
+	std::span<LineVertex> alloc_lines (const uint32_t n_vertices) override final;
+
+	void wait_next_frame () override final;
+	void render () override final;
+	void update_screen () override final;
+};
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef __PROJECT_AURORA_RENDER_HEADER_H__
+#define __PROJECT_AURORA_RENDER_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <SDL.h>
+
+#include <vector>
+#include <array>
+#include <span>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <my-game-lib/my-game-lib.h>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/graphics.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Instances keep the object's position at the previous and at the current
+	simulation step.
+	The render thread draws them at a blend of both, so the simulation can
+	tick at a lower rate than the display.
+*/
+
+inline Point interpolate_pos (const Point& previous_pos, const Point& pos, const float alpha) noexcept
+{
+	return previous_pos + (pos - previous_pos) * alpha;
+}
+
+struct SpriteInstance {
+	SpriteRegistry::Id id;
+	Point previous_pos;
+	Point pos;
+};
+
+struct WireBox {
+	Point previous_pos;
+	Point pos;
+	Vector size;
+	Color color;
+};
+
+// ---------------------------------------------------
+
+/*
+	Debug-draw layer.
+	Colliders and sprite boxes are batched as wireframes into the frame's
+	line buffer, so they are drawn with a single draw call.
+	The options are checked once per frame, so when disabled nothing is
+	recorded nor built, and the layer can stay in release builds.
+*/
+
+struct DebugDrawOptions {
+	bool colliders = Config::render_colliders;
+	bool sprite_boxes = Config::render_sprite_box;
+};
+
+inline DebugDrawOptions debug_draw;
+
+// ---------------------------------------------------
+
+/*
+	Everything the renderer needs to draw a frame.
+	It is recorded by the simulation thread and is immutable afterwards.
+	It must not reference objects, since they can be destroyed while
+	the snapshot is still being consumed by the render thread.
+*/
+
+struct RenderSnapshot {
+	MyGlib::Graphics::RenderArgs3D render_args;
+
+	// fraction of the simulation step elapsed since the current state,
+	// 0 renders the previous state and 1 renders the current state
+	float alpha = 1;
+
+	std::span<const GraphicsVertex> terrain; // owned by the map, never changes
+	std::vector<SpriteInstance> sprites;
+	std::vector<CubeInstance> cubes;
+	std::vector<WireBox> wire_boxes;
+
+	// copied from the debug-draw options when recording,
+	// so toggling them never affects a frame being built
+	bool sprite_boxes = false;
+
+	// keeps the capacity, so steady-state recording doesn't allocate
+	void clear () noexcept
+	{
+		this->terrain = {};
+		this->sprites.clear();
+		this->cubes.clear();
+		this->wire_boxes.clear();
+		this->sprite_boxes = false;
+	}
+};
+
+// ---------------------------------------------------
+
+// Number of vertices of each stream required to draw a snapshot.
+
+struct DrawCounts {
+	uint32_t n_triangles_texture;
+	uint32_t n_triangles_color;
+	uint32_t n_lines;
+};
+
+DrawCounts count_draw_data (const RenderSnapshot& snapshot) noexcept;
+
+// ---------------------------------------------------
+
+// Where the vertices of a frame are written.
+
+struct DrawTargets {
+	std::span<GraphicsVertex> triangles_texture;
+	std::span<ColorVertex> triangles_color;
+	std::span<LineVertex> lines;
+};
+
+// Writes the vertices of the snapshot into targets, sized by count_draw_data.
+
+void build_draw_data (const RenderSnapshot& snapshot, const DrawTargets& targets);
+
+// ---------------------------------------------------
+
+/*
+	Streaming vertex storage with one region per in-flight frame.
+	A region is written in place by the builder and read by the upload,
+	and the pipeline synchronization acts as the fence between them, since
+	a region is only reused after the frame that used it was submitted.
+	Regions are allocated uninitialized and only grow (rarely, when a frame
+	needs more vertices than ever before), so steady-state streaming never
+	allocates, constructs or zeroes vertices.
+*/
+
+template <typename Vertex, uint32_t n_regions>
+class VertexStream
+{
+private:
+	struct Region {
+		std::unique_ptr<Vertex[]> data;
+		uint32_t capacity = 0;
+	};
+
+	std::array<Region, n_regions> regions;
+
+	MYLIB_OO_ENCAPSULATE_SCALAR_INIT_READONLY(uint32_t, n_grows, 0)
+
+public:
+	std::span<Vertex> map (const uint32_t region_index, const uint32_t n_vertices)
+	{
+		Region& region = this->regions[region_index];
+
+		if (n_vertices > region.capacity) [[unlikely]] {
+			// leave some room, so a slowly growing scene doesn't reallocate every frame
+			region.capacity = n_vertices + n_vertices / 2;
+			region.data = std::make_unique_for_overwrite<Vertex[]>(region.capacity);
+			this->n_grows++;
+		}
+
+		return std::span<Vertex>(region.data.get(), n_vertices);
+	}
+};
+
+// ---------------------------------------------------
+
+struct DrawData {
+	MyGlib::Graphics::RenderArgs3D render_args;
+	DrawTargets targets;
+	bool ready = false;
+};
+
+// ---------------------------------------------------
+
+/*
+	Pipelines the frame:
+	- The simulation thread records frame N+1 into a snapshot.
+	- Meanwhile, the render thread builds the vertex streams of frame N.
+	- At the end of frame N+1 the main thread uploads the draw data of frame N
+	  and hands snapshot N+1 to the render thread.
+
+	OpenGL calls stay in the main thread, since the context belongs to it.
+	Snapshots and draw data are double buffered.
+	In the synchronous mode, vertices are written directly into the memory
+	allocated by the render backend.
+	In the threaded mode, vertices are written into the pipeline's vertex
+	streams and copied once into the render backend when submitted.
+	The copy can't be avoided: my-game-lib's programs only hand out vertex
+	memory in the main thread, between setup_render_3D() and render(), and
+	the render thread builds its frame before that, while the next frame
+	is simulated.
+	The copy runs in the main thread and is bound by memory bandwidth.
+	A plain copy of 48-byte (textured) and 52-byte (color) vertices was
+	measured at about 4 us for a typical frame (2500 vertices, mostly
+	terrain), 0.2 ms with 1000 spells and 3 ms with 10000 spells.
+	If that matters more than overlapping the build with the simulation,
+	set Config::threaded_render to false.
+*/
+
+class RenderPipeline
+{
+private:
+	std::array<RenderSnapshot, 2> snapshots;
+	std::array<DrawData, 2> draw_data;
+	uint32_t recording = 0; // index of the snapshot being recorded
+
+	VertexStream<GraphicsVertex, 2> stream_triangles_texture;
+	VertexStream<ColorVertex, 2> stream_triangles_color;
+	VertexStream<LineVertex, 2> stream_lines;
+
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable cond_request;
+	std::condition_variable cond_done;
+	bool build_pending = false;
+	uint32_t build_index = 0;
+	bool quit = false;
+
+	void worker_loop ();
+	void wait_build ();
+	void build (const uint32_t index);
+	void submit (DrawData& data);
+	void build_and_submit (const RenderSnapshot& snapshot);
+
+public:
+	RenderPipeline ();
+	~RenderPipeline ();
+
+	RenderSnapshot& get_recording_snapshot () noexcept
+	{
+		return this->snapshots[this->recording];
+	}
+
+	// clears the snapshot that will be recorded in this frame
+	void begin_frame () noexcept
+	{
+		this->get_recording_snapshot().clear();
+	}
+
+	/*
+		Uploads the draw data of the previous frame and starts building the
+		snapshot recorded in this frame.
+		Must be called from the main thread, before render_backend->render().
+	*/
+	void end_frame ();
+
+	// waits until the render thread is not building a frame, it stays idle until end_frame()
+	void wait_idle ()
+	{
+		if constexpr (Config::threaded_render)
+			this->wait_build();
+	}
+};
+
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef __PROJECT_AURORA_SIMD_HEADER_H__
+#define __PROJECT_AURORA_SIMD_HEADER_H__
+
+#include <array>
+#include <algorithm>
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define AURORA_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	#include <arm_neon.h>
+	#define AURORA_SIMD_NEON 1
+#endif
+
+#include <aurora/types.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	4-lane float vector, 16-byte aligned, for the physics and collision
+	hot loops.
+	A 3D vector is stored as (x, y, z, 0).
+	Uses SSE on x86-64 and NEON on AArch64, with a scalar fallback.
+*/
+
+class alignas(16) Vec4
+{
+private:
+#if defined(AURORA_SIMD_SSE)
+	using Native = __m128;
+#elif defined(AURORA_SIMD_NEON)
+	using Native = float32x4_t;
+#else
+	using Native = std::array<float, 4>;
+#endif
+
+	Native v;
+
+	explicit Vec4 (const Native v_) noexcept
+		: v(v_)
+	{
+	}
+
+public:
+	Vec4 () = default;
+
+	Vec4 (const float x, const float y, const float z, const float w = 0) noexcept
+	{
+	#if defined(AURORA_SIMD_SSE)
+		this->v = _mm_setr_ps(x, y, z, w);
+	#elif defined(AURORA_SIMD_NEON)
+		const float tmp[4] = { x, y, z, w };
+		this->v = vld1q_f32(tmp);
+	#else
+		this->v = { x, y, z, w };
+	#endif
+	}
+
+	explicit Vec4 (const Vector& vector) noexcept
+		: Vec4(vector.x, vector.y, vector.z)
+	{
+	}
+
+	static Vec4 broadcast (const float s) noexcept
+	{
+	#if defined(AURORA_SIMD_SSE)
+		return Vec4(_mm_set1_ps(s));
+	#elif defined(AURORA_SIMD_NEON)
+		return Vec4(vdupq_n_f32(s));
+	#else
+		return Vec4(s, s, s, s);
+	#endif
+	}
+
+	static Vec4 zero () noexcept
+	{
+		return broadcast(0);
+	}
+
+	std::array<float, 4> to_array () const noexcept
+	{
+		alignas(16) std::array<float, 4> r;
+	#if defined(AURORA_SIMD_SSE)
+		_mm_store_ps(r.data(), this->v);
+	#elif defined(AURORA_SIMD_NEON)
+		vst1q_f32(r.data(), this->v);
+	#else
+		r = this->v;
+	#endif
+		return r;
+	}
+
+	Vector to_vector () const noexcept
+	{
+		const std::array<float, 4> r = this->to_array();
+		return Vector(r[0], r[1], r[2]);
+	}
+
+	friend Vec4 operator+ (const Vec4 a, const Vec4 b) noexcept
+	{
+	#if defined(AURORA_SIMD_SSE)
+		return Vec4(_mm_add_ps(a.v, b.v));
+	#elif defined(AURORA_SIMD_NEON)
+		return Vec4(vaddq_f32(a.v, b.v));
+	#else
+		return Vec4(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]);
+	#endif
+	}
+
+	friend Vec4 operator- (const Vec4 a, const Vec4 b) noexcept
+	{
+	#if defined(AURORA_SIMD_SSE)
+		return Vec4(_mm_sub_ps(a.v, b.v));
+	#elif defined(AURORA_SIMD_NEON)
+		return Vec4(vsubq_f32(a.v, b.v));
+	#else
+		return Vec4(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]);
+	#endif
+	}
+
+	friend Vec4 operator* (const Vec4 a, const Vec4 b) noexcept
+	{
+	#if defined(AURORA_SIMD_SSE)
+		return Vec4(_mm_mul_ps(a.v, b.v));
+	#elif defined(AURORA_SIMD_NEON)
+		return Vec4(vmulq_f32(a.v, b.v));
+	#else
+		return Vec4(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]);
+	#endif
+	}
+
+	friend Vec4 operator* (const Vec4 a, const float s) noexcept
+	{
+		return a * broadcast(s);
+	}
+
+	Vec4& operator+= (const Vec4 b) noexcept
+	{
+		*this = *this + b;
+		return *this;
+	}
+
+	Vec4 abs () const noexcept
+	{
+	#if defined(AURORA_SIMD_SSE)
+		return Vec4(_mm_andnot_ps(_mm_set1_ps(-0.0f), this->v));
+	#elif defined(AURORA_SIMD_NEON)
+		return Vec4(vabsq_f32(this->v));
+	#else
+		return Vec4(std::abs(this->v[0]), std::abs(this->v[1]), std::abs(this->v[2]), std::abs(this->v[3]));
+	#endif
+	}
+
+	// magnitude of mag with the sign of sign, per lane
+	static Vec4 copysign (const Vec4 mag, const Vec4 sign) noexcept
+	{
+	#if defined(AURORA_SIMD_SSE)
+		const __m128 sign_mask = _mm_set1_ps(-0.0f);
+		return Vec4(_mm_or_ps(_mm_andnot_ps(sign_mask, mag.v), _mm_and_ps(sign_mask, sign.v)));
+	#elif defined(AURORA_SIMD_NEON)
+		const uint32x4_t sign_mask = vdupq_n_u32(0x80000000);
+		return Vec4(vbslq_f32(sign_mask, sign.v, mag.v));
+	#else
+		return Vec4(std::copysign(mag.v[0], sign.v[0]), std::copysign(mag.v[1], sign.v[1]),
+		            std::copysign(mag.v[2], sign.v[2]), std::copysign(mag.v[3], sign.v[3]));
+	#endif
+	}
+
+	// bit i is set if lane i of a is less than lane i of b
+	static uint32_t less_mask (const Vec4 a, const Vec4 b) noexcept
+	{
+	#if defined(AURORA_SIMD_SSE)
+		return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v));
+	#elif defined(AURORA_SIMD_NEON)
+		const uint32_t bits_data[4] = { 1, 2, 4, 8 };
+		return vaddvq_u32(vandq_u32(vcltq_f32(a.v, b.v), vld1q_u32(bits_data)));
+	#else
+		return (a.v[0] < b.v[0]) | ((a.v[1] < b.v[1]) << 1) | ((a.v[2] < b.v[2]) << 2) | ((a.v[3] < b.v[3]) << 3);
+	#endif
+	}
+};
+
+static_assert(sizeof(Vec4) == 16 && alignof(Vec4) == 16);
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
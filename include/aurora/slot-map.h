@@ -0,0 +1,206 @@
+#ifndef __PROJECT_AURORA_SLOT_MAP_HEADER_H__
+#define __PROJECT_AURORA_SLOT_MAP_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <vector>
+#include <span>
+#include <limits>
+#include <utility>
+
+#include <cstdint>
+
+#include <my-lib/std.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Generational handle to an element of a SlotMap.
+	When an element is erased, the generation of its slot is incremented,
+	so handles to the erased element are detected as stale, even after the
+	slot is reused.
+	Generation 0 is never used by a live element, so a default constructed
+	handle is always invalid.
+*/
+
+struct SlotHandle {
+	uint32_t index = 0;
+	uint32_t generation = 0;
+
+	bool operator== (const SlotHandle&) const noexcept = default;
+};
+
+// ---------------------------------------------------
+
+/*
+	Elements are stored contiguously in a dense array, so iteration never
+	chases pointers.
+	Insertion and erasure are O(1): erasure moves the last element into the
+	erased position (swap-and-pop), so the order of the elements is not kept,
+	and pointers to elements are invalidated by insertions and erasures.
+	Handles stay valid until their element is erased.
+*/
+
+template <typename T>
+class SlotMap
+{
+public:
+	using Handle = SlotHandle;
+
+private:
+	static constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+	struct Slot {
+		uint32_t dense_index;  // next free slot when the slot is free
+		uint32_t generation;
+	};
+
+	std::vector<T> dense;
+	std::vector<uint32_t> dense_to_slot;
+	std::vector<Slot> slots;
+	uint32_t free_head = invalid_index;
+
+	const Slot* find_slot (const Handle handle) const noexcept
+	{
+		if (handle.index >= this->slots.size()) [[unlikely]]
+			return nullptr;
+
+		const Slot& slot = this->slots[handle.index];
+
+		return (slot.generation == handle.generation) ? &slot : nullptr;
+	}
+
+public:
+	void reserve (const uint32_t n)
+	{
+		this->dense.reserve(n);
+		this->dense_to_slot.reserve(n);
+		this->slots.reserve(n);
+	}
+
+	Handle insert (T value)
+	{
+		uint32_t slot_index;
+
+		if (this->free_head != invalid_index) {
+			slot_index = this->free_head;
+			this->free_head = this->slots[slot_index].dense_index;
+		}
+		else {
+			slot_index = this->slots.size();
+			this->slots.push_back( Slot { .dense_index = invalid_index, .generation = 1 } );
+		}
+
+		Slot& slot = this->slots[slot_index];
+		slot.dense_index = this->dense.size();
+
+		this->dense.push_back( std::move(value) );
+		this->dense_to_slot.push_back(slot_index);
+
+		return Handle { .index = slot_index, .generation = slot.generation };
+	}
+
+	// returns false if the handle is stale
+	bool erase (const Handle handle)
+	{
+		if (this->find_slot(handle) == nullptr)
+			return false;
+
+		Slot& slot = this->slots[handle.index];
+		const uint32_t dense_index = slot.dense_index;
+		const uint32_t last = this->dense.size() - 1;
+
+		// destroyed only after the bookkeeping is done, in case its destructor accesses the map
+		T erased = std::move(this->dense[dense_index]);
+
+		if (dense_index != last) {
+			this->dense[dense_index] = std::move(this->dense[last]);
+			this->dense_to_slot[dense_index] = this->dense_to_slot[last];
+			this->slots[ this->dense_to_slot[dense_index] ].dense_index = dense_index;
+		}
+
+		this->dense.pop_back();
+		this->dense_to_slot.pop_back();
+
+		// skip generation 0 on wrap around, it is reserved for invalid handles
+		slot.generation++;
+		if (slot.generation == 0)
+			slot.generation = 1;
+
+		slot.dense_index = this->free_head;
+		this->free_head = handle.index;
+
+		return true;
+	}
+
+	bool contains (const Handle handle) const noexcept
+	{
+		return this->find_slot(handle) != nullptr;
+	}
+
+	// returns nullptr if the handle is stale
+	T* get (const Handle handle) noexcept
+	{
+		const Slot *slot = this->find_slot(handle);
+		return (slot != nullptr) ? &this->dense[slot->dense_index] : nullptr;
+	}
+
+	const T* get (const Handle handle) const noexcept
+	{
+		const Slot *slot = this->find_slot(handle);
+		return (slot != nullptr) ? &this->dense[slot->dense_index] : nullptr;
+	}
+
+	Handle get_handle (const uint32_t dense_index) const noexcept
+	{
+		const uint32_t slot_index = this->dense_to_slot[dense_index];
+		return Handle { .index = slot_index, .generation = this->slots[slot_index].generation };
+	}
+
+	uint32_t size () const noexcept
+	{
+		return this->dense.size();
+	}
+
+	bool empty () const noexcept
+	{
+		return this->dense.empty();
+	}
+
+	T& operator[] (const uint32_t dense_index) noexcept
+	{
+		return this->dense[dense_index];
+	}
+
+	const T& operator[] (const uint32_t dense_index) const noexcept
+	{
+		return this->dense[dense_index];
+	}
+
+	std::span<T> get_dense () noexcept
+	{
+		return this->dense;
+	}
+
+	std::span<const T> get_dense () const noexcept
+	{
+		return this->dense;
+	}
+
+	auto begin () noexcept { return this->dense.begin(); }
+	auto end () noexcept { return this->dense.end(); }
+	auto begin () const noexcept { return this->dense.begin(); }
+	auto end () const noexcept { return this->dense.end(); }
+};
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
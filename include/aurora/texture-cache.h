@@ -0,0 +1,83 @@
+#ifndef __PROJECT_AURORA_TEXTURE_CACHE_HEADER_H__
+#define __PROJECT_AURORA_TEXTURE_CACHE_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <SDL.h>
+
+#include <array>
+#include <span>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/types.h>
+#include <aurora/mapped-file.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Binary file with the decoded texels of all textures, in RGBA32 and in
+	loading order, so the atlas is packed exactly as if the images were
+	decoded.
+	The header stores a hash of the source images, and the cache is only
+	used when it matches, so a stale cache is never loaded.
+	The file is memory-mapped and the surfaces point straight into the
+	mapping, so loading a texture is just a memory-to-GPU upload.
+
+	Layout:
+	- Header
+	- Entry array, one per texture
+	- Texel data of each texture, aligned to Entry::alignment bytes
+*/
+
+class TextureCache
+{
+public:
+	struct Header {
+		std::array<char, 8> magic;
+		uint32_t version;
+		uint32_t n_textures;
+		uint64_t source_hash;
+	};
+
+	struct Entry {
+		static constexpr uint64_t alignment = 64;
+
+		uint32_t width;
+		uint32_t height;
+		uint32_t pitch;
+		uint32_t format; // SDL pixel format
+		uint64_t offset; // from the beginning of the file
+		uint64_t size;
+	};
+
+	static constexpr std::array<char, 8> magic = { 'A', 'U', 'R', 'T', 'E', 'X', 'C', 'H' };
+	static constexpr uint32_t version = 1;
+
+private:
+	MappedFile file;
+	std::span<const Entry> entries;
+
+public:
+	// returns false if the cache doesn't exist, is corrupted or was baked from other sources
+	bool open (const char *fname, const uint64_t source_hash, const uint32_t n_textures);
+
+	// the surface points into the mapping, so it must be freed before the cache
+	SDL_Surface* make_surface (const uint32_t i) const;
+
+	// surfaces must be in SDL_PIXELFORMAT_RGBA32
+	static bool write (const char *fname, const uint64_t source_hash, const std::span<SDL_Surface* const> surfaces);
+};
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
@@ -0,0 +1,125 @@
+#ifndef __PROJECT_AURORA_TEXTURE_STREAMER_HEADER_H__
+#define __PROJECT_AURORA_TEXTURE_STREAMER_HEADER_H__
+
+#ifdef __MINGW32__
+	#define SDL_MAIN_HANDLED
+#endif
+
+#include <SDL.h>
+
+#include <vector>
+#include <span>
+#include <map>
+#include <thread>
+#include <mutex>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+#include <my-lib/matrix.h>
+
+#include <my-game-lib/my-game-lib.h>
+
+#include <aurora/types.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Loads textures in the background, so the first frame doesn't wait for
+	the whole content set.
+	A requested texture is immediately replaced by its own placeholder entry
+	in the atlas, so it can be used right away.
+	A background thread decodes the images, nearest to the player first,
+	and the main thread uploads them at the beginning of a frame and
+	retargets the sprites created with the placeholder.
+	Frame matrices are allocated once by start(), and the loaded frames are
+	written into their cells, so spans into them stay valid.
+*/
+
+class TextureStreamer
+{
+private:
+	enum class State : uint32_t {
+		Pending,
+		Decoding,
+		Decoded,
+		Loaded
+	};
+
+	struct Request {
+		TextureDescriptor *texture;
+		Mylib::Matrix<TextureDescriptor> *frames; // nullptr if the texture is not split
+		uint32_t nrows;
+		uint32_t ncols;
+		const char *fname;
+
+		TextureDescriptor placeholder;
+		Mylib::Matrix<TextureDescriptor> placeholder_frames;
+
+		// protected by the mutex
+		State state = State::Pending;
+		Point pos; // nearest known user of the texture
+		bool has_pos = false;
+		SDL_Surface *surface = nullptr;
+	};
+
+	std::vector<Request> requests;
+	std::map<const void*, uint32_t> placeholder_requests; // placeholder (and its frames) -> request
+	SDL_Surface *placeholder_surface = nullptr;
+	uint32_t n_loaded = 0;
+
+	std::thread worker;
+	std::mutex mutex;
+	std::vector<uint32_t> decoded; // requests ready to be uploaded
+	Point focus = Point::zero();
+	bool quit = false;
+
+	void worker_loop ();
+	void add_request (Request&& request);
+
+public:
+	~TextureStreamer ();
+
+	/*
+		Must be called between render_backend->begin_texture_loading()
+		and render_backend->end_texture_loading(), before start().
+	*/
+	void request (TextureDescriptor& texture, const char *fname);
+	void request (TextureDescriptor& texture, Mylib::Matrix<TextureDescriptor>& frames, const uint32_t nrows, const uint32_t ncols, const char *fname);
+
+	// splits the placeholders and starts loading
+	void start ();
+	void stop ();
+
+	bool is_done () const noexcept
+	{
+		return (this->n_loaded == this->requests.size());
+	}
+
+	// position of the player
+	void set_focus (const Point& pos);
+
+	// some object at pos uses the texture
+	void hint (const TextureDescriptor& texture, const Point& pos);
+
+	// same as above for a batch of objects, with a single lookup and lock
+	void hint (const TextureDescriptor& texture, const std::span<const Point> positions);
+
+	/*
+		Uploads the textures decoded since the last call.
+		Must be called by the main thread at the beginning of a frame,
+		before objects are updated.
+	*/
+	void process ();
+};
+
+inline TextureStreamer texture_streamer;
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
\ No newline at end of file
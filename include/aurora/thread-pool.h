@@ -0,0 +1,79 @@
+#ifndef __PROJECT_AURORA_THREAD_POOL_HEADER_H__
+#define __PROJECT_AURORA_THREAD_POOL_HEADER_H__
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include <my-lib/std.h>
+#include <my-lib/macros.h>
+
+#include <aurora/types.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+/*
+	Fixed set of worker threads that execute the tasks of one job at a time.
+	The calling thread also executes tasks, and run() only returns when all
+	tasks of the job are done.
+	Jobs are not type-erased into std::function, so running a job never
+	allocates memory.
+	Must be used by a single thread at a time.
+*/
+
+class ThreadPool
+{
+private:
+	using TaskFunction = void (*) (void *ctx, const uint32_t task);
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable cond_job;
+	std::condition_variable cond_done;
+
+	// current job, only written while no worker is busy
+	TaskFunction function = nullptr;
+	void *ctx = nullptr;
+	uint32_t n_tasks = 0;
+	uint64_t generation = 0;
+	uint32_t n_busy = 0;
+	bool quit = false;
+
+	std::atomic<uint32_t> next_task = 0;
+	std::atomic<uint32_t> n_done = 0;
+
+	void worker_loop ();
+	void execute_tasks ();
+	void run_job (const uint32_t n_tasks_, TaskFunction function_, void *ctx_);
+
+public:
+	// n_workers does not include the calling thread
+	ThreadPool (const uint32_t n_workers);
+	~ThreadPool ();
+
+	uint32_t get_n_threads () const noexcept
+	{
+		return this->threads.size() + 1;
+	}
+
+	// calls job(task) for every task in [0, n_tasks)
+	template <typename Job>
+	void run (const uint32_t n_tasks_, Job& job)
+	{
+		this->run_job(n_tasks_, [] (void *ctx_, const uint32_t task) {
+			(*static_cast<Job*>(ctx_))(task);
+		}, &job);
+	}
+};
+
+// ---------------------------------------------------
+
+} // end namespace Game
+
+#endif
@@ -49,6 +49,8 @@ using MyGlib::Graphics::Opengl::Opengl_TextureDescriptor;
 using Colors = MyGlib::Graphics::Colors;
 using AudioDescriptor = MyGlib::Audio::Descriptor;
 using GraphicsVertex = MyGlib::Graphics::Opengl::ProgramTriangleTexture::Vertex;
+using ColorVertex = MyGlib::Graphics::Opengl::ProgramTriangleColor::Vertex;
+using LineVertex = MyGlib::Graphics::Opengl::ProgramLineColor::Vertex;
 
 using VectorBasis = Mylib::Math::VectorBasis3<float>;
 using Line = Mylib::Math::Line<float, 3>;
@@ -58,8 +60,6 @@ using Clock = std::chrono::steady_clock;
 using ClockDuration = Clock::duration;
 using ClockTime = Clock::time_point;
 
-using FooEvent = int;
-
 using Coroutine = Mylib::Coroutine<1024>;
 
 // ---------------------------------------------------
@@ -8,8 +8,9 @@
 #include <SDL.h>
 
 #include <vector>
+#include <span>
 #include <memory>
-#include <list>
+#include <type_traits>
 
 #include <my-lib/std.h>
 #include <my-lib/macros.h>
@@ -21,6 +22,10 @@
 #include <aurora/types.h>
 #include <aurora/graphics.h>
 #include <aurora/object.h>
+#include <aurora/physics.h>
+#include <aurora/slot-map.h>
+#include <aurora/object-pool.h>
+#include <aurora/effects.h>
 
 
 namespace Game
@@ -56,6 +61,9 @@ public:
 
 	float get_z (const Vector2& pos) const noexcept;
 
+	// out[i] = get_z(positions[i])
+	void get_z (const std::span<const Point2> positions, const std::span<float> out) const noexcept;
+
 	inline Vector2 get_size () const noexcept
 	{
 		return Vector2(this->tiles.get_ncols(), this->tiles.get_nrows());
@@ -72,13 +80,86 @@ private:
 	MYLIB_OO_ENCAPSULATE_OBJ_INIT_WITH_COPY_MOVE(Vector, camera_pos, Vector::zero())
 	MYLIB_OO_ENCAPSULATE_OBJ_INIT_WITH_COPY_MOVE(Color, ambient_light_color, Colors::white)
 	MYLIB_OO_ENCAPSULATE_OBJ_WITH_COPY_MOVE(LightPointDescriptor, light)
+	MYLIB_OO_ENCAPSULATE_OBJ(EffectSystem, effects)
+
+	// declared before the buckets, so the pooled objects are destroyed before their pools
+	ObjectPool<SpellObject> spell_pool;
+	ObjectPool<StaticObjectSprite> prop_pool;
+
+	/*
+		One bucket per ObjectKind, objects are owned by the bucket of their kind.
+		Objects are polymorphic, so they can't be stored by value: the buckets
+		are dense arrays of owning pointers, iterated without lookups, and the
+		objects themselves live in the pools (spells and props) or in the heap.
+		Since the pointers are owning, an object never moves while alive.
+		Removing an object moves the last object of its bucket into its
+		place, so the update and render order of the objects changes when
+		objects are removed, and no code may rely on it.
+		References to objects kept from one frame to the next must be
+		ObjectHandles resolved with get_object(), never raw pointers.
+	*/
+	SlotMap< std::unique_ptr<StaticObject, ObjectDeleter> > static_objects;
+	SlotMap< std::unique_ptr<DynamicObject, ObjectDeleter> > dynamic_objects;
+	std::vector<ObjectHandle> objects_to_remove_next_frame;
+
+	// physics step data, reused every step
+	// the colliders of the static objects come first, see process_object_collision
+	std::vector<Collider*> step_colliders;
+	std::vector<BroadphaseBox> broadphase_boxes;
+	std::vector<BroadphasePair> broadphase_pairs;
+
+	struct CollisionEvent {
+		Collider *a;
+		Collider *b;
+		Vector ds; // displacement of b
+	};
+
+	// collision callbacks are called once the physics step is done
+	std::vector<CollisionEvent> collision_events;
+
+	// ground heights and positions of the props spawned by add_props_at_ground
+	std::vector<float> spawn_ground_z;
+	std::vector<Point> spawn_pos;
+
+	ObjectHandle player;
+
+	template <ObjectKind kind>
+	auto& get_bucket () noexcept
+	{
+		if constexpr (kind == ObjectKind::Static)
+			return this->static_objects;
+		else {
+			static_assert(kind == ObjectKind::Dynamic);
+			return this->dynamic_objects;
+		}
+	}
+
+	template <ObjectKind kind>
+	void insert_object_in_bucket (Object *object)
+	{
+		auto& bucket = this->get_bucket<kind>();
+		using Ptr = typename std::remove_reference_t<decltype(bucket[0])>;
+		using Type = typename Ptr::element_type;
+
+		// the kind tag guarantees the cast is valid
+		Type *obj = static_cast<Type*>(object);
+
+		// static objects may be placed (e.g., at ground) after construction
+		obj->store_previous_state();
 
-	std::list< std::unique_ptr<Object> > objects;
-	std::list< StaticObject* > static_objects;
-	std::list< DynamicObject* > dynamic_objects;
-	std::list<Object*> objects_to_remove_next_frame;
+		const SlotHandle slot = bucket.insert( Ptr(obj) );
+		obj->set_handle( ObjectHandle { .kind = kind, .slot = slot } );
+	}
+
+	// takes the ownership of the object
+	void insert_object (Object *object);
 
-	PlayerObject *player;
+	template <ObjectKind kind>
+	StaticObject* get_object_in_bucket (const SlotHandle slot) noexcept
+	{
+		auto *ptr = this->get_bucket<kind>().get(slot);
+		return (ptr != nullptr) ? ptr->get() : nullptr;
+	}
 
 public:
 	World ();
@@ -86,15 +167,55 @@ public:
 	void process_physics (const float dt) noexcept;
 	void process_map_collision () noexcept;
 	void process_object_collision () noexcept;
-	void render (const float dt);
+	void render (const float dt, const float alpha);
 	void process_update (const float dt);
+	void store_previous_state () noexcept;
 
 	Object* add_object (std::unique_ptr<Object> object);
 	StaticObject* add_static_object_at_ground (std::unique_ptr<StaticObject> object);
 
+	/*
+		Spawns one prop of the subtype's sprite blueprint at ground level at
+		each position.
+		Storage is reserved once for the whole batch, the ground heights are
+		sampled in a single pass, the sprite is interned and hinted to the
+		texture streamer once, and each prop is constructed in the prop pool
+		with its collider and inserted into the static bucket in the same
+		loop.
+	*/
+	void add_props_at_ground (const Object::Subtype subtype, const std::span<const Point2> positions);
+
+	template <typename T>
+	ObjectPool<T>& get_pool () noexcept
+	{
+		if constexpr (std::is_same_v<T, StaticObjectSprite>)
+			return this->prop_pool;
+		else {
+			static_assert(std::is_same_v<T, SpellObject>, "no pool for this type");
+			return this->spell_pool;
+		}
+	}
+
+	// constructs the object in its pool, without touching the heap once the pool is warm
+	template <typename T, typename... Args>
+	T* add_pooled_object (Args&&... args)
+	{
+		T *obj = this->get_pool<T>().construct(this, std::forward<Args>(args)...);
+		this->insert_object(obj);
+		return obj;
+	}
+
+	// returns nullptr if the object was already destroyed
+	StaticObject* get_object (const ObjectHandle handle) noexcept;
+
+	// requests for an object that is already queued are ignored
 	void remove_object_next_frame (Object *object)
 	{
-		this->objects_to_remove_next_frame.push_back(object);
+		if (object->get_removal_pending())
+			return;
+
+		object->set_removal_pending(true);
+		this->objects_to_remove_next_frame.push_back( object->get_value_handle() );
 	}
 
 	void frame_finished ();
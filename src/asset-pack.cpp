@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cstring>
+
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/asset-pack.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+bool AssetPack::open (const char *fname)
+{
+	using namespace AssetPackFormat;
+
+	if (!this->file.open(fname))
+		return false;
+
+	const std::span<std::byte> data = this->file.get_data();
+
+	auto fail = [this] () -> bool {
+		this->entries = {};
+		this->names = {};
+		this->file.close();
+		return false;
+	};
+
+	if (data.size() < sizeof(Header))
+		return fail();
+
+	Header header;
+	std::memcpy(&header, data.data(), sizeof(Header));
+
+	if (header.magic != magic || header.version != version)
+		return fail();
+
+	if (data.size() < (sizeof(Header) + header.n_entries * sizeof(Entry))
+		|| (header.names_offset + header.names_size) > data.size())
+		return fail();
+
+	// mmap returns page-aligned memory, so the entries are properly aligned
+	this->entries = std::span<const Entry>(reinterpret_cast<const Entry*>(data.data() + sizeof(Header)), header.n_entries);
+	this->names = std::string_view(reinterpret_cast<const char*>(data.data() + header.names_offset), header.names_size);
+
+	for (const Entry& entry : this->entries) {
+		if ((entry.name_offset + entry.name_size) > header.names_size
+			|| (entry.offset + entry.size) > data.size())
+			return fail();
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------
+
+std::span<std::byte> AssetPack::find (const std::string_view name) const noexcept
+{
+	auto it = std::lower_bound(this->entries.begin(), this->entries.end(), name,
+		[this] (const AssetPackFormat::Entry& entry, const std::string_view name) -> bool {
+			return this->get_name(entry) < name;
+		});
+
+	if (it == this->entries.end() || this->get_name(*it) != name)
+		return std::span<std::byte>();
+
+	return this->file.get_data().subspan(it->offset, it->size);
+}
+
+// ---------------------------------------------------
+
+bool AssetFiles::open (AssetFile& file, const char *fname) const
+{
+	file.loose.close();
+	file.data = this->pack.find(fname);
+
+	if (!file.data.empty())
+		return true;
+
+	if (!file.loose.open(fname))
+		return false;
+
+	file.data = file.loose.get_data();
+
+	return true;
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
@@ -0,0 +1,195 @@
+#include <array>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+#include <utility>
+#include <charconv>
+#include <system_error>
+
+#include <boost/container/static_vector.hpp>
+
+#include <my-lib/std.h>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/graphics.h>
+#include <aurora/asset-pack.h>
+#include <aurora/object.h>
+#include <aurora/blueprint.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+static constexpr auto subtype_names = std::to_array<std::string_view>({
+	#define _MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_(TYPE, V) #V,
+	_MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUES_
+	#undef _MYLIB_ENUM_CLASS_OBJECT_SUBTYPE_VALUE_
+});
+
+static_assert(subtype_names.size() == Object::n_subtypes);
+
+// ---------------------------------------------------
+
+// textures that blueprints can reference by name
+
+static const auto sprite_textures = std::to_array< std::pair<std::string_view, TextureDescriptor*> >({
+	{ "tree_00", &Texture::tree_00 },
+	{ "castle_00", &Texture::castle_00 },
+	{ "enemy_00", &Texture::enemy_00 },
+	{ "grass", &Texture::grass },
+	{ "water", &Texture::water }
+});
+
+static TextureDescriptor* find_sprite_texture (const std::string_view name)
+{
+	for (const auto& [texture_name, texture] : sprite_textures) {
+		if (texture_name == name)
+			return texture;
+	}
+
+	return nullptr;
+}
+
+// ---------------------------------------------------
+
+static std::optional<Object::Subtype> find_subtype (const std::string_view name)
+{
+	for (uint32_t i = 0; i < subtype_names.size(); i++) {
+		if (subtype_names[i] == name)
+			return static_cast<Object::Subtype>(i);
+	}
+
+	return std::nullopt;
+}
+
+// ---------------------------------------------------
+
+static bool parse_float (const std::string_view token, float& value)
+{
+	const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+	return ec == std::errc() && ptr == (token.data() + token.size());
+}
+
+// ---------------------------------------------------
+
+void BlueprintRegistry::load (const char *fname)
+{
+	AssetFile file;
+	const bool success = asset_files.open(file, fname);
+
+	mylib_assert_msg(success, "failed to open blueprints file ", fname);
+
+	const auto data = file.get_data();
+
+	this->parse(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()), fname);
+}
+
+// ---------------------------------------------------
+
+/*
+	One blueprint per line, fields separated by spaces:
+
+	<Subtype> sprite <texture> <collider xyz> <size xy> <source anchor xy> <dest anchor xyz>
+
+	A zero collider size means no collider.
+	Everything after a # is a comment.
+*/
+
+void BlueprintRegistry::parse (const std::string_view text, const char *fname)
+{
+	static constexpr uint32_t n_sprite_tokens = 13;
+
+	uint32_t line_number = 0;
+	size_t line_begin = 0;
+
+	this->loaded.fill(false);
+
+	while (line_begin < text.size()) {
+		size_t line_end = text.find('\n', line_begin);
+
+		if (line_end == std::string_view::npos)
+			line_end = text.size();
+
+		std::string_view line = text.substr(line_begin, line_end - line_begin);
+		line_begin = line_end + 1;
+		line_number++;
+
+		if (const size_t comment = line.find('#'); comment != std::string_view::npos)
+			line = line.substr(0, comment);
+
+		boost::container::static_vector<std::string_view, n_sprite_tokens> tokens;
+		size_t pos = 0;
+
+		while (true) {
+			pos = line.find_first_not_of(" \t\r", pos);
+
+			if (pos == std::string_view::npos)
+				break;
+
+			const size_t end = std::min(line.find_first_of(" \t\r", pos), line.size());
+
+			mylib_assert_msg(tokens.size() < tokens.capacity(), fname, ":", line_number, ": too many fields");
+
+			tokens.push_back(line.substr(pos, end - pos));
+			pos = end;
+		}
+
+		if (tokens.empty())
+			continue;
+
+		const auto subtype = find_subtype(tokens[0]);
+
+		mylib_assert_msg(subtype.has_value(), fname, ":", line_number, ": unknown subtype ", tokens[0]);
+		mylib_assert_msg(!this->loaded[ std::to_underlying(*subtype) ], fname, ":", line_number, ": duplicated blueprint for ", tokens[0]);
+		mylib_assert_msg(tokens.size() >= 2, fname, ":", line_number, ": missing blueprint kind");
+
+		Blueprint blueprint = {};
+		blueprint.subtype = *subtype;
+
+		mylib_assert_msg(tokens[1] == "sprite", fname, ":", line_number, ": unknown blueprint kind ", tokens[1]);
+		mylib_assert_msg(tokens.size() == n_sprite_tokens, fname, ":", line_number, ": sprite blueprints have ", n_sprite_tokens, " fields");
+
+		blueprint.texture = find_sprite_texture(tokens[2]);
+
+		mylib_assert_msg(blueprint.texture != nullptr, fname, ":", line_number, ": unknown texture ", tokens[2]);
+
+		// the fields after the texture are all numbers
+		std::array<float, n_sprite_tokens - 3> numbers;
+
+		for (uint32_t i = 3; i < tokens.size(); i++) {
+			const bool valid = parse_float(tokens[i], numbers[i - 3]);
+			mylib_assert_msg(valid, fname, ":", line_number, ": invalid number ", tokens[i]);
+		}
+
+		blueprint.collider_size = Vector3(numbers[0], numbers[1], numbers[2]);
+		blueprint.sprite_size = Vector2(numbers[3], numbers[4]);
+		blueprint.sprite_source_anchor = Vector2(numbers[5], numbers[6]);
+		blueprint.sprite_dest_anchor = Vector3(numbers[7], numbers[8], numbers[9]);
+
+		this->blueprints[ std::to_underlying(*subtype) ] = blueprint;
+		this->loaded[ std::to_underlying(*subtype) ] = true;
+	}
+}
+
+// ---------------------------------------------------
+
+void add_blueprint_collider (StaticObject *obj, const Blueprint& blueprint)
+{
+	if (blueprint.collider_size == Vector3::zero())
+		return;
+
+	obj->get_colliders().push_back(Collider {
+		.object = obj,
+		.ds = Vector::zero(),
+		.size = blueprint.collider_size,
+		.id = 0
+	});
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
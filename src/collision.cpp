@@ -7,6 +7,7 @@
 #include <aurora/object.h>
 #include <aurora/collision.h>
 #include <aurora/world.h>
+#include <aurora/render.h>
 
 
 namespace Game
@@ -14,74 +15,52 @@ namespace Game
 
 // ---------------------------------------------------
 
-std::pair<bool, Vector> check_collision (const Collider& a, const Collider& b)
+ColliderBox Collider::get_box () const noexcept
 {
-	Vector collision_vector;
-
-	const Vector a_pos = a.object->get_ref_pos() + a.ds;
-	const Vector b_pos = b.object->get_ref_pos() + b.ds;
+	return ColliderBox {
+		.center = Vec4(this->object->get_ref_pos() + this->ds),
+		.half_size = Vec4(this->size / fp(2))
+	};
+}
 
-	const Vector distance = b_pos - a_pos;
-	const Vector target_distance = a.size / fp(2) + b.size / fp(2);
+// ---------------------------------------------------
 
+std::pair<bool, Vector> check_collision (const Collider& a, const Collider& b)
+{
 	/*
 		Let's think a bit.
-		First, we only care about a valid collision_vector
+		First, we only care about a valid displacement vector
 		if the colliders are colliding.
-		If they are not colliding, we don't care if the collision_vector
+		If they are not colliding, we don't care if the displacement
 		calculated is valid or not.
-	*/
 
-	/*
-		x axis is in the right direction in the plane.
-		If b is right of a, then the distance.x is positive.
+		For each axis (x right, y up and z altitude, since we use
+		right-handed coordinates), if b is at the positive side of a,
+		then the distance is positive.
 		Since the collider returns what we should do with object b
-		to solve the collision, collision_vector.x should be positive.
+		to solve the collision, the displacement should be positive.
 		Otherwise, it should be negative.
+		test_collision() does this for the 3 axes at once.
 	*/
 
-	const bool colliding_x = std::abs(distance.x) < target_distance.x;
-	collision_vector.x = std::copysign(target_distance.x - std::abs(distance.x), distance.x);
+	Vec4 ds;
+	const bool colliding = test_collision(a.get_box(), b.get_box(), ds);
 
-	/*
-		y axis is in the up direction in the plane.
-		If b is above a, then the distance.y is positive.
-		Since the collider returns what we should do with object b
-		to solve the collision, collision_vector.y should be positive.
-		Otherwise, it should be negative.
-	*/
-
-	const bool colliding_y = std::abs(distance.y) < target_distance.y;
-	collision_vector.y = std::copysign(target_distance.y - std::abs(distance.y), distance.y);
-
-	/*
-		z axis represents the altitude.
-		The higher the altitude, the higher the z value, since we use right-handed coordinates.
-		If b is above a, then the distance.y is positive.
-		Since the collider returns what we should do with object b
-		to solve the collision, collision_vector.y should be positive.
-		Otherwise, it should be negative.
-	*/
-
-	const bool colliding_z = std::abs(distance.z) < target_distance.z;
-	collision_vector.z = std::copysign(target_distance.z - std::abs(distance.z), distance.z);
-
-	return std::pair<bool, Vector>(colliding_x && colliding_y && colliding_z, collision_vector);
+	return std::pair<bool, Vector>(colliding, ds.to_vector());
 }
 
 // ---------------------------------------------------
 
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
-
 void Collider::render (const Color& color) const
 {
-	auto cube = WireCube3D(this->size);
-
-	renderer->draw_wire_cube3D(cube, this->object->get_ref_pos() + this->ds, color);
+	render_pipeline->get_recording_snapshot().wire_boxes.push_back( WireBox {
+		.previous_pos = this->object->get_ref_previous_pos() + this->ds,
+		.pos = this->object->get_ref_pos() + this->ds,
+		.size = this->size,
+		.color = color
+	} );
 }
 
-#endif
-
 // ---------------------------------------------------
 
 } // end namespace Game
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include <utility>
+#include <algorithm>
+#include <span>
+
+#include <cstring>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/globals.h>
+#include <aurora/graphics.h>
+#include <aurora/effects.h>
+#include <aurora/render.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+// GCC/clang vector extension, compiles to SSE on x86 and NEON on ARM
+using float4 = float __attribute__ ((vector_size (EffectPool::simd_width * sizeof(float))));
+
+// ---------------------------------------------------
+
+EffectPool::EffectPool (const uint32_t capacity_, const std::span<TextureDescriptor> textures, const Vector2 size_, const Vector2 source_anchor_, const Vector3& dest_anchor_, const float frame_duration_)
+	: frame_duration(frame_duration_),
+	  life_span(frame_duration_ * static_cast<float>(textures.size()))
+{
+	// round up so that the simd loops never need a scalar tail
+	this->capacity = ((capacity_ + simd_width - 1) / simd_width) * simd_width;
+
+	this->frames.reserve(textures.size());
+
+	for (const auto& texture : textures)
+		this->frames.push_back(Sprite(nullptr, texture, size_, source_anchor_, dest_anchor_));
+
+	this->pos_x.resize(this->capacity);
+	this->pos_y.resize(this->capacity);
+	this->pos_z.resize(this->capacity);
+	this->age.resize(this->capacity);
+}
+
+// ---------------------------------------------------
+
+void EffectPool::emit (const Point& pos) noexcept
+{
+	if (this->n_alive == this->capacity) [[unlikely]] {
+		this->n_dropped++;
+		return;
+	}
+
+	const uint32_t i = this->n_alive++;
+
+	this->pos_x[i] = pos.x;
+	this->pos_y[i] = pos.y;
+	this->pos_z[i] = pos.z;
+	this->age[i] = 0;
+}
+
+// ---------------------------------------------------
+
+void EffectPool::emit_scattered (const Point& center, const Vector& spread, const uint32_t n, RandomGenerator& gen) noexcept
+{
+	const uint32_t first = this->n_alive;
+	const uint32_t n_emitted = std::min(n, this->capacity - first);
+
+	this->n_dropped += n - n_emitted;
+
+	gen.fill_floats(std::span(this->pos_x).subspan(first, n_emitted), center.x - spread.x, center.x + spread.x);
+	gen.fill_floats(std::span(this->pos_y).subspan(first, n_emitted), center.y - spread.y, center.y + spread.y);
+	gen.fill_floats(std::span(this->pos_z).subspan(first, n_emitted), center.z - spread.z, center.z + spread.z);
+	std::fill_n(this->age.begin() + first, n_emitted, 0.0f);
+
+	this->n_alive += n_emitted;
+}
+
+// ---------------------------------------------------
+
+void EffectPool::update (const float dt) noexcept
+{
+	float *age = this->age.data();
+	const uint32_t n_blocks = (this->n_alive + simd_width - 1) / simd_width;
+	const float4 vdt = { dt, dt, dt, dt };
+
+	// Lanes after n_alive are garbage, but they are inside capacity,
+	// so it is safe to update them.
+
+	for (uint32_t b = 0; b < n_blocks; b++) {
+		float4 v;
+		std::memcpy(&v, age + b*simd_width, sizeof(float4));
+		v += vdt;
+		std::memcpy(age + b*simd_width, &v, sizeof(float4));
+	}
+
+	// recycle expired slots with swap-and-pop
+
+	uint32_t i = 0;
+
+	while (i < this->n_alive) {
+		if (age[i] >= this->life_span) {
+			const uint32_t last = --this->n_alive;
+
+			this->pos_x[i] = this->pos_x[last];
+			this->pos_y[i] = this->pos_y[last];
+			this->pos_z[i] = this->pos_z[last];
+			this->age[i] = this->age[last];
+		}
+		else
+			i++;
+	}
+}
+
+// ---------------------------------------------------
+
+void EffectPool::render ()
+{
+	std::vector<SpriteInstance>& sprites = render_pipeline->get_recording_snapshot().sprites;
+
+	const uint32_t last_frame = this->frames.size() - 1;
+	const float inv_frame_duration = fp(1) / this->frame_duration;
+
+	for (uint32_t i = 0; i < this->n_alive; i++) {
+		const uint32_t frame = std::min(static_cast<uint32_t>(this->age[i] * inv_frame_duration), last_frame);
+		const Point pos(this->pos_x[i], this->pos_y[i], this->pos_z[i]);
+
+		// effects don't move
+		sprites.push_back( SpriteInstance {
+			.id = this->frames[frame].get_id(),
+			.previous_pos = pos,
+			.pos = pos
+		} );
+	}
+}
+
+// ---------------------------------------------------
+
+EffectSystem::EffectSystem ()
+{
+	this->pools[ std::to_underlying(EffectType::Explosion) ] = EffectPool(
+		Config::max_effects_per_type,
+		Texture::matrix_explosion.to_span(),
+		Vector2(2, 2),
+		Vector2(0, 0),
+		Vector3(0, 0, 0),
+		0.05f
+	);
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
@@ -0,0 +1,209 @@
+#include <thread>
+#include <algorithm>
+
+#include <cmath>
+
+#if defined(__unix__)
+	#include <time.h>
+	#include <errno.h>
+#endif
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/frame-pacer.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+static double thread_cpu_time () noexcept
+{
+#if defined(__unix__)
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+	return 0;
+#endif
+}
+
+static double to_seconds (const ClockDuration d) noexcept
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+// ---------------------------------------------------
+
+static void sleep_until (const ClockTime& t)
+{
+#if defined(__unix__)
+	// steady_clock is CLOCK_MONOTONIC on POSIX systems
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+
+	struct timespec ts;
+	ts.tv_sec = ns / 1000000000;
+	ts.tv_nsec = ns % 1000000000;
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR);
+#else
+	std::this_thread::sleep_until(t);
+#endif
+}
+
+// ---------------------------------------------------
+
+FramePacer::FramePacer (const Mode mode_, const float target_dt)
+	: mode(mode_), period(float_to_ClockDuration(target_dt))
+{
+}
+
+// ---------------------------------------------------
+
+void FramePacer::wait (const ClockTime& frame_begin)
+{
+	const double cpu_begin = thread_cpu_time();
+
+	switch (this->mode) {
+		case Mode::Precise:
+			this->wait_precise();
+		break;
+
+		case Mode::Legacy:
+			this->wait_legacy(frame_begin);
+		break;
+	}
+
+	this->stats.wait_cpu_time += thread_cpu_time() - cpu_begin;
+	this->stats.n_frames++;
+}
+
+// ---------------------------------------------------
+
+void FramePacer::wait_precise ()
+{
+	ClockTime now = Clock::now();
+
+	if (!this->started) {
+		this->deadline = now + this->period;
+		this->started = true;
+	}
+
+	if (now >= this->deadline) {
+		this->stats.n_late++;
+
+		// we missed the deadline, re-synchronize instead of rushing the next frames
+		this->deadline = now + this->period;
+		return;
+	}
+
+	const ClockTime wake_up = this->deadline - this->margin;
+
+	if (now < wake_up) {
+		sleep_until(wake_up);
+
+		const ClockTime after_sleep = Clock::now();
+		this->calibrate(after_sleep - wake_up);
+		this->stats.sleep_time += to_seconds(after_sleep - now);
+		now = after_sleep;
+	}
+
+	const ClockTime spin_begin = now;
+
+	while (now < this->deadline)
+		now = Clock::now();
+
+	this->stats.spin_time += to_seconds(now - spin_begin);
+	this->add_jitter(now, this->deadline);
+
+	this->deadline += this->period;
+}
+
+// ---------------------------------------------------
+
+void FramePacer::wait_legacy (const ClockTime& frame_begin)
+{
+	const ClockTime frame_deadline = frame_begin + this->period;
+	const ClockTime before_sleep = Clock::now();
+	const float required_dt = ClockDuration_to_float(before_sleep - frame_begin);
+
+	if constexpr (Config::sleep_to_save_cpu) {
+		if (required_dt < Config::sleep_threshold)
+			std::this_thread::sleep_for(float_to_ClockDuration(Config::sleep_threshold - required_dt));
+	}
+
+	const ClockTime before_busy_wait = Clock::now();
+	ClockTime now = before_busy_wait;
+
+	if constexpr (Config::busy_wait_to_ensure_fps) {
+		while (now < frame_deadline)
+			now = Clock::now();
+	}
+
+	if (before_sleep >= frame_deadline)
+		this->stats.n_late++;
+	else
+		this->add_jitter(now, frame_deadline);
+
+	this->stats.sleep_time += to_seconds(before_busy_wait - before_sleep);
+	this->stats.spin_time += to_seconds(now - before_busy_wait);
+}
+
+// ---------------------------------------------------
+
+void FramePacer::calibrate (const ClockDuration oversleep) noexcept
+{
+	// exponentially weighted mean and mean deviation, like TCP's round-trip estimator
+	constexpr float weight = 0.05f;
+
+	const float sample = ClockDuration_to_float(oversleep);
+	const float error = sample - this->oversleep_mean;
+
+	this->oversleep_mean += weight * error;
+	this->oversleep_deviation += weight * (std::abs(error) - this->oversleep_deviation);
+
+	const ClockDuration margin_ = float_to_ClockDuration(this->oversleep_mean + 4.0f * this->oversleep_deviation);
+
+	this->margin = std::clamp(margin_, min_margin, max_margin);
+}
+
+// ---------------------------------------------------
+
+void FramePacer::add_jitter (const ClockTime& wake_up, const ClockTime& deadline_) noexcept
+{
+	const double jitter = std::abs(to_seconds(wake_up - deadline_));
+
+	this->stats.sum_jitter += jitter;
+	this->stats.max_jitter = std::max(this->stats.max_jitter, jitter);
+}
+
+// ---------------------------------------------------
+
+void FramePacer::report () const
+{
+	const Stats& s = this->stats;
+
+	if (s.n_frames == 0)
+		return;
+
+	const uint64_t n_on_time = s.n_frames - s.n_late;
+	const double wait_time = s.sleep_time + s.spin_time;
+
+	dprintln("frame pacer (", (this->mode == Mode::Precise) ? "precise" : "legacy", "):",
+		" frames=", s.n_frames,
+		" late=", s.n_late,
+		" avg_jitter_us=", (n_on_time > 0) ? (s.sum_jitter / n_on_time * 1e6) : 0.0,
+		" max_jitter_us=", s.max_jitter * 1e6,
+		" margin_us=", to_seconds(this->margin) * 1e6,
+		" sleep_s=", s.sleep_time,
+		" spin_s=", s.spin_time,
+		" wait_cpu_s=", s.wait_cpu_time,
+		" wait_cpu_usage=", (wait_time > 0) ? (s.wait_cpu_time / wait_time) : 0.0
+		);
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
@@ -1,9 +1,24 @@
+#include <array>
+#include <utility>
+#include <string_view>
+#include <limits>
+
+#include <cmath>
+
+#include <SDL_image.h>
+
 #include <aurora/config.h>
 #include <aurora/types.h>
 #include <aurora/lib.h>
 #include <aurora/globals.h>
 #include <aurora/graphics.h>
 #include <aurora/object.h>
+#include <aurora/render.h>
+#include <aurora/render-backend.h>
+#include <aurora/thread-pool.h>
+#include <aurora/asset-pack.h>
+#include <aurora/texture-cache.h>
+#include <aurora/texture-streamer.h>
 
 
 namespace Game
@@ -33,40 +48,131 @@ static VectorBasis basis_camera; // z is the camera vector in the opposite direc
 
 // ---------------------------------------------------
 
+template <size_t n>
+static void load_texture_sources (const std::array<std::pair<TextureDescriptor*, const char*>, n>& files, std::array<SDL_Surface*, n>& surfaces)
+{
+	auto decode = [&files, &surfaces] (const uint32_t i) {
+		AssetFile file;
+		SDL_Surface *decoded = nullptr;
+
+		if (asset_files.open(file, files[i].second))
+			decoded = IMG_Load_RW(file.make_rwops(), 1);
+
+		// a single pixel format, so baked textures are packed exactly as the decoded ones
+		if (decoded != nullptr && decoded->format->format != SDL_PIXELFORMAT_RGBA32) {
+			surfaces[i] = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0);
+			SDL_FreeSurface(decoded);
+		}
+		else
+			surfaces[i] = decoded;
+	};
+
+	thread_pool->run(n, decode);
+
+	for (uint32_t i = 0; i < n; i++)
+		mylib_assert_msg(surfaces[i] != nullptr, "failed to load texture ", files[i].second);
+}
+
+// ---------------------------------------------------
+
+/*
+	Decoding the images dominates the loading time, so they are decoded
+	in parallel by the thread pool.
+	Then, they are packed into the atlas by the calling thread, which owns
+	the graphics context, always in the order of the table below.
+	This way, the atlas layout doesn't depend on the number of threads
+	nor on which image finishes decoding first.
+
+	Only the textures required by the first frame are loaded here, the
+	others are streamed by the TextureStreamer.
+
+	The decoded images are baked into the texture cache.
+	In the next runs, if the source images didn't change, the surfaces
+	point straight into the memory-mapped cache and nothing is decoded.
+*/
+
 static void load_textures ()
 {
 	using namespace Texture;
 
-	renderer->begin_texture_loading();
-
-	tree_00 = renderer->load_texture("assets/tree_00.png");
-	castle_00 = renderer->load_texture("assets/castle_00.png");
-
-	main_char_south = renderer->load_texture("assets/main-char-walk/GreatSwordKnight_2hWalk_dir_south-cropped.png");
-	main_char_south_west = renderer->load_texture("assets/main-char-walk/GreatSwordKnight_2hWalk_dir_south_west-cropped.png");
-	main_char_west = renderer->load_texture("assets/main-char-walk/GreatSwordKnight_2hWalk_dir_west-cropped.png");
-	main_char_north_west = renderer->load_texture("assets/main-char-walk/GreatSwordKnight_2hWalk_dir_north_west-cropped.png");
-	main_char_north = renderer->load_texture("assets/main-char-walk/GreatSwordKnight_2hWalk_dir_north-cropped.png");
-	main_char_north_east = renderer->load_texture("assets/main-char-walk/GreatSwordKnight_2hWalk_dir_north_east-cropped.png");
-	main_char_east = renderer->load_texture("assets/main-char-walk/GreatSwordKnight_2hWalk_dir_east-cropped.png");
-	main_char_south_east = renderer->load_texture("assets/main-char-walk/GreatSwordKnight_2hWalk_dir_south_east-cropped.png");
-	grass = renderer->load_texture("assets/grass.png");
-	water = renderer->load_texture("assets/water.png");
-	enemy_00 = renderer->load_texture("assets/enemy_00.png");
-	explosion = renderer->load_texture("assets/explosion_001S.png");
-	
-	renderer->end_texture_loading();
+	// needed by the first frame: the map and the player
+	const auto files = std::to_array< std::pair<TextureDescriptor*, const char*> >({
+		{ &main_char_south, "assets/main-char-walk/GreatSwordKnight_2hWalk_dir_south-cropped.png" },
+		{ &main_char_south_west, "assets/main-char-walk/GreatSwordKnight_2hWalk_dir_south_west-cropped.png" },
+		{ &main_char_west, "assets/main-char-walk/GreatSwordKnight_2hWalk_dir_west-cropped.png" },
+		{ &main_char_north_west, "assets/main-char-walk/GreatSwordKnight_2hWalk_dir_north_west-cropped.png" },
+		{ &main_char_north, "assets/main-char-walk/GreatSwordKnight_2hWalk_dir_north-cropped.png" },
+		{ &main_char_north_east, "assets/main-char-walk/GreatSwordKnight_2hWalk_dir_north_east-cropped.png" },
+		{ &main_char_east, "assets/main-char-walk/GreatSwordKnight_2hWalk_dir_east-cropped.png" },
+		{ &main_char_south_east, "assets/main-char-walk/GreatSwordKnight_2hWalk_dir_south_east-cropped.png" },
+		{ &grass, "assets/grass.png" },
+		{ &water, "assets/water.png" }
+	});
+
+	std::array<SDL_Surface*, files.size()> surfaces;
+	TextureCache cache;
+	bool cached = false;
+
+	if constexpr (Config::use_texture_cache) {
+		std::array<uint64_t, files.size()> file_hashes;
+
+		// hashing the sources is much cheaper than decoding them
+		auto hash = [&files, &file_hashes] (const uint32_t i) {
+			AssetFile file;
+			const std::string_view fname = files[i].second;
+
+			file_hashes[i] = hash_fnv1a(std::as_bytes(std::span(fname)));
+
+			if (asset_files.open(file, files[i].second))
+				file_hashes[i] = hash_fnv1a(file.get_data(), file_hashes[i]);
+		};
+
+		thread_pool->run(files.size(), hash);
+
+		const uint64_t source_hash = hash_fnv1a(std::as_bytes(std::span(file_hashes)));
+
+		cached = cache.open(Config::texture_cache_fname, source_hash, files.size());
+
+		if (cached) {
+			for (uint32_t i = 0; i < files.size(); i++)
+				surfaces[i] = cache.make_surface(i);
+		}
+		else {
+			dprintln("texture cache ", Config::texture_cache_fname, " is missing or outdated, baking it");
+			load_texture_sources(files, surfaces);
+
+			if (!TextureCache::write(Config::texture_cache_fname, source_hash, surfaces))
+				dprintln("failed to write texture cache ", Config::texture_cache_fname);
+		}
+	}
+	else
+		load_texture_sources(files, surfaces);
+
+	render_backend->begin_texture_loading();
 
-	matrix_main_char_south = renderer->split_texture(main_char_south, 3, 3);
-	matrix_main_char_south_west = renderer->split_texture(main_char_south_west, 3, 3);
-	matrix_main_char_west = renderer->split_texture(main_char_west, 3, 3);
-	matrix_main_char_north_west = renderer->split_texture(main_char_north_west, 3, 3);
-	matrix_main_char_north = renderer->split_texture(main_char_north, 3, 3);
-	matrix_main_char_north_east = renderer->split_texture(main_char_north_east, 3, 3);
-	matrix_main_char_east = renderer->split_texture(main_char_east, 3, 3);
-	matrix_main_char_south_east = renderer->split_texture(main_char_south_east, 3, 3);
+	for (uint32_t i = 0; i < files.size(); i++) {
+		*files[i].first = render_backend->load_texture(surfaces[i]);
+		SDL_FreeSurface(surfaces[i]);
+	}
 
-	matrix_explosion = renderer->split_texture(explosion, 3, 3);
+	// everything else is streamed in the background
+	texture_streamer.request(tree_00, "assets/tree_00.png");
+	texture_streamer.request(castle_00, "assets/castle_00.png");
+	texture_streamer.request(enemy_00, "assets/enemy_00.png");
+	texture_streamer.request(explosion, matrix_explosion, 3, 3, "assets/explosion_001S.png");
+	
+	render_backend->end_texture_loading();
+
+	matrix_main_char_south = render_backend->split_texture(main_char_south, 3, 3);
+	matrix_main_char_south_west = render_backend->split_texture(main_char_south_west, 3, 3);
+	matrix_main_char_west = render_backend->split_texture(main_char_west, 3, 3);
+	matrix_main_char_north_west = render_backend->split_texture(main_char_north_west, 3, 3);
+	matrix_main_char_north = render_backend->split_texture(main_char_north, 3, 3);
+	matrix_main_char_north_east = render_backend->split_texture(main_char_north_east, 3, 3);
+	matrix_main_char_east = render_backend->split_texture(main_char_east, 3, 3);
+	matrix_main_char_south_east = render_backend->split_texture(main_char_south_east, 3, 3);
+
+	texture_streamer.start();
 }
 
 // ---------------------------------------------------
@@ -81,134 +187,222 @@ void load_graphics ()
 
 // ---------------------------------------------------
 
-Sprite::Sprite (StaticObject *object_, const TextureDescriptor& texture_, const Vector2 size_, const Vector2 source_anchor_, const Vector3& dest_anchor_)
-	: object(object_), texture(texture_) //size(size_), ds(ds_)
+static SpriteRegistry::Vertices build_sprite_vertices (const TextureDescriptor& texture_, const Vector2 size_, const Vector2 source_anchor_, const Vector3& dest_anchor_)
 {
-	using enum MyGlib::Graphics::Enums::TextureVertexPositionIndex;
+	using enum Sprite::PositionIndex;
+
+	SpriteRegistry::Vertices graphics_vertices;
 
 	const Vector half_size = size_ / fp(2);
 
-	const Opengl_TextureDescriptor *desc = this->texture.info->data.get_value<Opengl_TextureDescriptor*>();
+	const TextureCoords tex_coords = render_backend->get_texture_coords(texture_);
 
 	// First, we set coordinates considering that sprite coordinate (0, 0, 0)
 	// is at the center of the sprite.
 
-	this->graphics_vertices[WestSouth].gvertex.pos.x = -half_size.x;
-	this->graphics_vertices[WestSouth].gvertex.pos.y = -half_size.y;
-	this->graphics_vertices[WestSouth].gvertex.pos.z = 0;
+	graphics_vertices[WestSouth].gvertex.pos.x = -half_size.x;
+	graphics_vertices[WestSouth].gvertex.pos.y = -half_size.y;
+	graphics_vertices[WestSouth].gvertex.pos.z = 0;
 
-	this->graphics_vertices[EastSouth].gvertex.pos.x = half_size.x;
-	this->graphics_vertices[EastSouth].gvertex.pos.y = -half_size.y;
-	this->graphics_vertices[EastSouth].gvertex.pos.z = 0;
+	graphics_vertices[EastSouth].gvertex.pos.x = half_size.x;
+	graphics_vertices[EastSouth].gvertex.pos.y = -half_size.y;
+	graphics_vertices[EastSouth].gvertex.pos.z = 0;
 
-	this->graphics_vertices[WestNorth].gvertex.pos.x = -half_size.x;
-	this->graphics_vertices[WestNorth].gvertex.pos.y = half_size.y;
-	this->graphics_vertices[WestNorth].gvertex.pos.z = 0;
+	graphics_vertices[WestNorth].gvertex.pos.x = -half_size.x;
+	graphics_vertices[WestNorth].gvertex.pos.y = half_size.y;
+	graphics_vertices[WestNorth].gvertex.pos.z = 0;
 
-	this->graphics_vertices[EastNorth].gvertex.pos.x = half_size.x;
-	this->graphics_vertices[EastNorth].gvertex.pos.y = half_size.y;
-	this->graphics_vertices[EastNorth].gvertex.pos.z = 0;
+	graphics_vertices[EastNorth].gvertex.pos.x = half_size.x;
+	graphics_vertices[EastNorth].gvertex.pos.y = half_size.y;
+	graphics_vertices[EastNorth].gvertex.pos.z = 0;
 
 	// Now, we need to perform a translation to source_anchor.
 
 	const Vector source_anchor = Vector(source_anchor_.x * size_.x, source_anchor_.y * size_.y, 0);
 
-	this->graphics_vertices[WestSouth].gvertex.pos -= source_anchor;
-	this->graphics_vertices[EastSouth].gvertex.pos -= source_anchor;
-	this->graphics_vertices[WestNorth].gvertex.pos -= source_anchor;
-	this->graphics_vertices[EastNorth].gvertex.pos -= source_anchor;
+	graphics_vertices[WestSouth].gvertex.pos -= source_anchor;
+	graphics_vertices[EastSouth].gvertex.pos -= source_anchor;
+	graphics_vertices[WestNorth].gvertex.pos -= source_anchor;
+	graphics_vertices[EastNorth].gvertex.pos -= source_anchor;
 
 	// Now, we need to rotate the sprite.
 	// First, we rotate the sprite around the z axis 45 degress clock-wise.
 	// Then, we rotate the sprite to align it with the camera vector.
 
 #if 1
-	this->graphics_vertices[WestSouth].gvertex.pos.rotate(q_camera_rotation);
-	this->graphics_vertices[EastSouth].gvertex.pos.rotate(q_camera_rotation);
-	this->graphics_vertices[WestNorth].gvertex.pos.rotate(q_camera_rotation);
-	this->graphics_vertices[EastNorth].gvertex.pos.rotate(q_camera_rotation);
+	graphics_vertices[WestSouth].gvertex.pos.rotate(q_camera_rotation);
+	graphics_vertices[EastSouth].gvertex.pos.rotate(q_camera_rotation);
+	graphics_vertices[WestNorth].gvertex.pos.rotate(q_camera_rotation);
+	graphics_vertices[EastNorth].gvertex.pos.rotate(q_camera_rotation);
 #endif
 
 #if 0
-	this->graphics_vertices[WestSouth].gvertex.pos.rotate(q_rotation_45_degrees);
-	this->graphics_vertices[EastSouth].gvertex.pos.rotate(q_rotation_45_degrees);
-	this->graphics_vertices[WestNorth].gvertex.pos.rotate(q_rotation_45_degrees);
-	this->graphics_vertices[EastNorth].gvertex.pos.rotate(q_rotation_45_degrees);
+	graphics_vertices[WestSouth].gvertex.pos.rotate(q_rotation_45_degrees);
+	graphics_vertices[EastSouth].gvertex.pos.rotate(q_rotation_45_degrees);
+	graphics_vertices[WestNorth].gvertex.pos.rotate(q_rotation_45_degrees);
+	graphics_vertices[EastNorth].gvertex.pos.rotate(q_rotation_45_degrees);
 #endif
 
 #if 0
-	this->graphics_vertices[WestSouth].gvertex.pos.rotate(q_rotation_to_camera_vector);
-	this->graphics_vertices[EastSouth].gvertex.pos.rotate(q_rotation_to_camera_vector);
-	this->graphics_vertices[WestNorth].gvertex.pos.rotate(q_rotation_to_camera_vector);
-	this->graphics_vertices[EastNorth].gvertex.pos.rotate(q_rotation_to_camera_vector);
+	graphics_vertices[WestSouth].gvertex.pos.rotate(q_rotation_to_camera_vector);
+	graphics_vertices[EastSouth].gvertex.pos.rotate(q_rotation_to_camera_vector);
+	graphics_vertices[WestNorth].gvertex.pos.rotate(q_rotation_to_camera_vector);
+	graphics_vertices[EastNorth].gvertex.pos.rotate(q_rotation_to_camera_vector);
 #endif
 
 	// Now, we need to perform a translation to dest_anchor.
 
-	this->graphics_vertices[WestSouth].gvertex.pos += dest_anchor_;
-	this->graphics_vertices[EastSouth].gvertex.pos += dest_anchor_;
-	this->graphics_vertices[WestNorth].gvertex.pos += dest_anchor_;
-	this->graphics_vertices[EastNorth].gvertex.pos += dest_anchor_;
+	graphics_vertices[WestSouth].gvertex.pos += dest_anchor_;
+	graphics_vertices[EastSouth].gvertex.pos += dest_anchor_;
+	graphics_vertices[WestNorth].gvertex.pos += dest_anchor_;
+	graphics_vertices[EastNorth].gvertex.pos += dest_anchor_;
 
 	// copy redundant vertices positions
 
-	this->graphics_vertices[EastSouthRepeat].gvertex.pos = this->graphics_vertices[EastSouth].gvertex.pos;
-	this->graphics_vertices[WestNorthRepeat].gvertex.pos = this->graphics_vertices[WestNorth].gvertex.pos;
+	graphics_vertices[EastSouthRepeat].gvertex.pos = graphics_vertices[EastSouth].gvertex.pos;
+	graphics_vertices[WestNorthRepeat].gvertex.pos = graphics_vertices[WestNorth].gvertex.pos;
 
 	// first triangle - tex coords
 
-	this->graphics_vertices[WestSouth].tex_coords = Vector(desc->tex_coords[LeftBottom].x, desc->tex_coords[LeftBottom].y, desc->atlas->texture_depth);
-	this->graphics_vertices[EastSouth].tex_coords = Vector(desc->tex_coords[RightBottom].x, desc->tex_coords[RightBottom].y, desc->atlas->texture_depth);
-	this->graphics_vertices[WestNorth].tex_coords = Vector(desc->tex_coords[LeftTop].x, desc->tex_coords[LeftTop].y, desc->atlas->texture_depth);
+	graphics_vertices[WestSouth].tex_coords = tex_coords.left_bottom;
+	graphics_vertices[EastSouth].tex_coords = tex_coords.right_bottom;
+	graphics_vertices[WestNorth].tex_coords = tex_coords.left_top;
 
 	// second triangle - tex coords
 
-	this->graphics_vertices[EastSouthRepeat].tex_coords = this->graphics_vertices[EastSouth].tex_coords;
-	this->graphics_vertices[EastNorth].tex_coords = Vector(desc->tex_coords[RightTop].x, desc->tex_coords[RightTop].y, desc->atlas->texture_depth);
-	this->graphics_vertices[WestNorthRepeat].tex_coords = this->graphics_vertices[WestNorth].tex_coords;
+	graphics_vertices[EastSouthRepeat].tex_coords = graphics_vertices[EastSouth].tex_coords;
+	graphics_vertices[EastNorth].tex_coords = tex_coords.right_top;
+	graphics_vertices[WestNorthRepeat].tex_coords = graphics_vertices[WestNorth].tex_coords;
 
 	// normals
 
-	for (auto& gv : this->graphics_vertices)
+	for (auto& gv : graphics_vertices)
 		gv.gvertex.normal = basis_camera.vz;
+
+	return graphics_vertices;
+}
+
+// ---------------------------------------------------
+
+SpriteRegistry::Id SpriteRegistry::intern (const TextureDescriptor& texture_, const Vector2 size, const Vector2 source_anchor, const Vector3& dest_anchor)
+{
+	const auto alias = this->aliases.find(texture_.info);
+	const TextureDescriptor& texture = (alias == this->aliases.end()) ? texture_ : alias->second;
+
+	const Key key(texture.info, size.x, size.y, source_anchor.x, source_anchor.y, dest_anchor.x, dest_anchor.y, dest_anchor.z);
+
+	if (const auto it = this->ids.find(key); it != this->ids.end())
+		return it->second;
+
+	const Id id = this->n_entries;
+	const uint32_t chunk = id / chunk_size;
+
+	mylib_assert_msg(chunk < max_chunks, "sprite registry is full");
+
+	// Chunks are never reallocated, so readers of older ids are not affected.
+	if (!this->chunks[chunk])
+		this->chunks[chunk] = std::make_unique<Chunk>();
+
+	(*this->chunks[chunk])[id % chunk_size] = build_sprite_vertices(texture, size, source_anchor, dest_anchor);
+
+	this->n_entries++;
+	this->ids.emplace(key, id);
+
+	return id;
+}
+
+// ---------------------------------------------------
+
+void SpriteRegistry::retarget (const TextureDescriptor& from, const TextureDescriptor& to)
+{
+	if (from.info == to.info)
+		return;
+
+	this->aliases[from.info] = to;
+
+	// keys are sorted by texture first, so the entries of "from" are contiguous
+	constexpr float lowest = std::numeric_limits<float>::lowest();
+	auto it = this->ids.lower_bound(Key(from.info, lowest, lowest, lowest, lowest, lowest, lowest, lowest));
+
+	while (it != this->ids.end() && std::get<0>(it->first) == from.info) {
+		const auto [info, size_x, size_y, source_anchor_x, source_anchor_y, dest_anchor_x, dest_anchor_y, dest_anchor_z] = it->first;
+		const Id id = it->second;
+
+		this->get_mutable(id) = build_sprite_vertices(to, Vector2(size_x, size_y), Vector2(source_anchor_x, source_anchor_y), Vector3(dest_anchor_x, dest_anchor_y, dest_anchor_z));
+
+		// if the loaded texture was already interned with the same geometry, we keep that entry
+		this->ids.emplace(Key(to.info, size_x, size_y, source_anchor_x, source_anchor_y, dest_anchor_x, dest_anchor_y, dest_anchor_z), id);
+
+		it = this->ids.erase(it);
+	}
+}
+
+// ---------------------------------------------------
+
+Sprite::Sprite (StaticObject *object_, const TextureDescriptor& texture_, const Vector2 size_, const Vector2 source_anchor_, const Vector3& dest_anchor_)
+	: object(object_), texture(texture_),
+	  id(sprite_registry.intern(texture_, size_, source_anchor_, dest_anchor_))
+{
+	if (object_ != nullptr)
+		texture_streamer.hint(texture_, object_->get_ref_pos());
+}
+
+Sprite::Sprite (StaticObject *object_, const TextureDescriptor& texture_, const SpriteRegistry::Id id_)
+	: object(object_), texture(texture_), id(id_)
+{
 }
 
 // ---------------------------------------------------
 
 void Sprite::render ()
 {
-	// update global positions
-	for (auto& gv : this->graphics_vertices)
-		gv.offset = this->object->get_ref_pos();
-
-	MyGlib::Graphics::Opengl::Renderer *opengl_renderer = static_cast<MyGlib::Graphics::Opengl::Renderer*>(renderer);
-	MyGlib::Graphics::Opengl::ProgramTriangleTexture& program = *opengl_renderer->get_program_triangle_texture();
-	const uint32_t n_vertices = this->graphics_vertices.size();
-	auto vertices = program.alloc_vertices(n_vertices);
-
-	// doing counter clock-wise
-	for (uint32_t i = 0; i < n_vertices; i++)
-		vertices[i] = graphics_vertices[i];
-
-	if constexpr (Config::render_sprite_box) {
-		MyGlib::Graphics::Opengl::ProgramLineColor& program = *opengl_renderer->get_program_line_color();
-		constexpr uint32_t n_vertices = 8;
-		auto vertices = program.alloc_vertices(n_vertices);
-
-		// counter clock-wise
-
-		vertices[0].gvertex = this->graphics_vertices[WestSouth].gvertex;
-		vertices[1].gvertex = this->graphics_vertices[WestNorth].gvertex;
-		vertices[2].gvertex = this->graphics_vertices[WestNorth].gvertex;
-		vertices[3].gvertex = this->graphics_vertices[EastNorth].gvertex;
-		vertices[4].gvertex = this->graphics_vertices[EastNorth].gvertex;
-		vertices[5].gvertex = this->graphics_vertices[EastSouth].gvertex;
-		vertices[6].gvertex = this->graphics_vertices[EastSouth].gvertex;
-		vertices[7].gvertex = this->graphics_vertices[WestSouth].gvertex;
-
-		for (auto& vertex : vertices) {
-			vertex.offset = this->object->get_ref_pos();
-			vertex.color = Colors::blue;
+	render_pipeline->get_recording_snapshot().sprites.push_back( SpriteInstance {
+		.id = this->id,
+		.previous_pos = this->object->get_ref_previous_pos(),
+		.pos = this->object->get_ref_pos()
+	} );
+}
+
+// ---------------------------------------------------
+
+void AnimationTrack::advance (const float dt) noexcept
+{
+	this->current_frame_time += dt;
+
+	while (this->current_frame_time >= this->frame_duration) {
+		this->current_frame_time -= this->frame_duration;
+		this->tick++;
+	}
+}
+
+// ---------------------------------------------------
+
+AnimationTrack* AnimationTrackManager::acquire (std::vector<SpriteRegistry::Id> frames, const float frame_duration)
+{
+	mylib_assert_msg(frames.size() > 0, "animation without frames");
+	mylib_assert_msg(frame_duration > 0, "animation frame duration must be positive");
+
+	Key key(std::move(frames), frame_duration);
+	auto it = this->tracks.find(key);
+
+	if (it == this->tracks.end())
+		it = this->tracks.try_emplace(key, key.first, frame_duration).first;
+
+	it->second.n_users++;
+
+	return &it->second;
+}
+
+// ---------------------------------------------------
+
+void AnimationTrackManager::process (const float dt) noexcept
+{
+	for (auto it = this->tracks.begin(); it != this->tracks.end(); ) {
+		if (it->second.n_users == 0)
+			it = this->tracks.erase(it);
+		else {
+			it->second.advance(dt);
+			++it;
 		}
 	}
 }
@@ -216,33 +410,147 @@ void Sprite::render ()
 // ---------------------------------------------------
 
 SpriteAnimation::SpriteAnimation (StaticObject *object_, std::span<TextureDescriptor> textures, const Vector2 size_, const Vector2 source_anchor_, const Vector3& dest_anchor_, const float frame_duration_)
-	: object(object_), frame_duration(frame_duration_)
+	: object(object_)
 {
-	this->sprites.reserve(textures.size());
+	std::vector<SpriteRegistry::Id> frames;
+	frames.reserve(textures.size());
+
+	for (const auto& texture : textures) {
+		frames.push_back( sprite_registry.intern(texture, size_, source_anchor_, dest_anchor_) );
 
-	for (const auto& texture : textures)
-		this->sprites.push_back(Sprite(object_, texture, size_, source_anchor_, dest_anchor_));
+		if (object_ != nullptr)
+			texture_streamer.hint(texture, object_->get_ref_pos());
+	}
+
+	this->track = animation_track_manager.acquire(std::move(frames), frame_duration_);
+	this->set_running_frame(0);
+}
+
+// ---------------------------------------------------
+
+SpriteAnimation::SpriteAnimation (SpriteAnimation&& other) noexcept
+	: object(other.object),
+	  track(std::exchange(other.track, nullptr)),
+	  phase(other.phase),
+	  stopped(other.stopped)
+{
+}
+
+SpriteAnimation& SpriteAnimation::operator= (SpriteAnimation&& other) noexcept
+{
+	if (this != &other) {
+		this->release();
+
+		this->object = other.object;
+		this->track = std::exchange(other.track, nullptr);
+		this->phase = other.phase;
+		this->stopped = other.stopped;
+	}
+
+	return *this;
+}
+
+// ---------------------------------------------------
+
+void SpriteAnimation::set_frame_duration (const float frame_duration)
+{
+	const uint32_t frame = this->get_current_frame();
+	AnimationTrack *new_track = animation_track_manager.acquire(this->track->get_frames(), frame_duration);
+
+	this->release();
+	this->track = new_track;
+
+	if (this->stopped)
+		this->phase = frame;
+	else
+		this->set_running_frame(frame);
 }
 
 // ---------------------------------------------------
 
 void SpriteAnimation::render (const float dt)
 {
-	this->sprites[this->current_frame].render();
+	render_pipeline->get_recording_snapshot().sprites.push_back( SpriteInstance {
+		.id = this->track->get_frames()[ this->get_current_frame() ],
+		.previous_pos = this->object->get_ref_previous_pos(),
+		.pos = this->object->get_ref_pos()
+	} );
+}
 
-	if (this->stopped == false) {
-		this->current_frame_time += dt;
+// ---------------------------------------------------
 
-		if (this->current_frame_time >= this->frame_duration) {
-			this->current_frame_time = 0;
-			this->current_frame++;
+struct CubeTemplateVertex {
+	Vector pos;
+	Vector normal;
+};
 
-			if (this->current_frame >= this->sprites.size()) {
-				this->current_frame = 0;
-				this->event_handler.publish(0);
-			}
+static std::array<CubeTemplateVertex, n_vertices_per_cube> build_unit_cube ()
+{
+	// for each face: normal, and two tangents u and v such that cross(u, v) = normal
+	constexpr std::array<std::array<Vector, 3>, 6> faces = {{
+		{ Vector(1, 0, 0), Vector(0, 1, 0), Vector(0, 0, 1) },
+		{ Vector(-1, 0, 0), Vector(0, 0, 1), Vector(0, 1, 0) },
+		{ Vector(0, 1, 0), Vector(0, 0, 1), Vector(1, 0, 0) },
+		{ Vector(0, -1, 0), Vector(1, 0, 0), Vector(0, 0, 1) },
+		{ Vector(0, 0, 1), Vector(1, 0, 0), Vector(0, 1, 0) },
+		{ Vector(0, 0, -1), Vector(0, 1, 0), Vector(1, 0, 0) }
+	}};
+
+	// counter clock-wise when looking at the face from outside
+	constexpr std::array<std::array<float, 2>, 6> corners = {{
+		{ -1, -1 }, { 1, -1 }, { -1, 1 },
+		{ 1, -1 }, { 1, 1 }, { -1, 1 }
+	}};
+
+	std::array<CubeTemplateVertex, n_vertices_per_cube> r;
+	uint32_t k = 0;
+
+	for (const auto& [normal, u, v] : faces) {
+		for (const auto& [cu, cv] : corners) {
+			r[k].pos = (normal + u * cu + v * cv) / fp(2);
+			r[k].normal = normal;
+			k++;
 		}
 	}
+
+	return r;
+}
+
+static const auto unit_cube = build_unit_cube();
+
+// ---------------------------------------------------
+
+void write_cube_vertices (const CubeInstance& instance, const float alpha, ColorVertex *out) noexcept
+{
+	// Rodrigues' rotation formula as a 3x3 matrix, computed once per instance
+	// and applied to all of its vertices on the CPU (see CubeInstance).
+
+	const Vector& a = instance.axis;
+	const float c = std::cos(instance.angle);
+	const float s = std::sin(instance.angle);
+	const float t = fp(1) - c;
+
+	const Vector row0(t*a.x*a.x + c,     t*a.x*a.y - s*a.z, t*a.x*a.z + s*a.y);
+	const Vector row1(t*a.x*a.y + s*a.z, t*a.y*a.y + c,     t*a.y*a.z - s*a.x);
+	const Vector row2(t*a.x*a.z - s*a.y, t*a.y*a.z + s*a.x, t*a.z*a.z + c);
+
+	auto rotate = [&row0, &row1, &row2] (const Vector& v) -> Vector {
+		return Vector(
+			row0.x*v.x + row0.y*v.y + row0.z*v.z,
+			row1.x*v.x + row1.y*v.y + row1.z*v.z,
+			row2.x*v.x + row2.y*v.y + row2.z*v.z
+		);
+	};
+
+	const Point pos = interpolate_pos(instance.previous_pos, instance.pos, alpha);
+
+	for (const CubeTemplateVertex& tv : unit_cube) {
+		ColorVertex& vertex = *out++;
+		vertex.gvertex.pos = rotate(tv.pos * instance.size);
+		vertex.gvertex.normal = rotate(tv.normal);
+		vertex.offset = pos;
+		vertex.color = instance.color;
+	}
 }
 
 // ---------------------------------------------------
@@ -0,0 +1,142 @@
+#include <algorithm>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/input.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+static uint32_t scancode_to_key (const SDL_Scancode scancode) noexcept
+{
+	switch (scancode) {
+		case SDL_SCANCODE_UP:
+			return InputSampler::Up;
+		case SDL_SCANCODE_DOWN:
+			return InputSampler::Down;
+		case SDL_SCANCODE_LEFT:
+			return InputSampler::Left;
+		case SDL_SCANCODE_RIGHT:
+			return InputSampler::Right;
+		default:
+			return 0;
+	}
+}
+
+// ---------------------------------------------------
+
+void InputSampler::start ()
+{
+	SDL_AddEventWatch(&InputSampler::event_watch, this);
+}
+
+void InputSampler::stop ()
+{
+	SDL_DelEventWatch(&InputSampler::event_watch, this);
+}
+
+// ---------------------------------------------------
+
+/*
+	Called by SDL when an event is added to its queue. Keyboard events are
+	added by SDL_PumpEvents on the main thread, the same thread that
+	samples them, so no synchronization is needed.
+	The event timestamp has only millisecond resolution, so we use it to
+	know how long ago the event happened, relative to now.
+*/
+
+int InputSampler::event_watch (void *userdata, SDL_Event *event)
+{
+	InputSampler *self = static_cast<InputSampler*>(userdata);
+
+	if ((event->type != SDL_KEYDOWN && event->type != SDL_KEYUP) || event->key.repeat)
+		return 0;
+
+	const uint32_t key = scancode_to_key(event->key.keysym.scancode);
+
+	if (key == 0)
+		return 0;
+
+	const uint32_t age_ms = SDL_GetTicks() - event->key.timestamp;
+	const ClockTime time = Clock::now() - std::chrono::milliseconds(age_ms);
+
+	if (event->type == SDL_KEYDOWN)
+		self->keys |= key;
+	else
+		self->keys &= ~key;
+
+	self->oldest_event_time = std::min(self->oldest_event_time, time);
+	self->has_new_input = true;
+	self->stats.n_events++;
+
+	return 0;
+}
+
+// ---------------------------------------------------
+
+void InputSampler::sample ()
+{
+	const ClockTime now = Clock::now();
+
+	// an input may wait up to this long in the OS queue before SDL timestamps it
+	if (this->has_sampled) {
+		const double interval = std::chrono::duration<double>(now - this->last_sample_time).count();
+
+		this->stats.n_pumps++;
+		this->stats.sum_pump_interval += interval;
+		this->stats.max_pump_interval = std::max(this->stats.max_pump_interval, interval);
+	}
+
+	this->last_sample_time = now;
+	this->has_sampled = true;
+
+	// The threaded render pipeline presents a frame one frame later.
+	constexpr uint32_t delay = Config::threaded_render ? 1 : 0;
+
+	this->pending_input_time[delay] = this->oldest_event_time;
+	this->has_pending_input[delay] = this->has_new_input;
+
+	this->oldest_event_time = ClockTime::max();
+	this->has_new_input = false;
+}
+
+// ---------------------------------------------------
+
+void InputSampler::frame_presented ()
+{
+	if (this->has_pending_input[0]) {
+		const double latency = std::chrono::duration<double>(Clock::now() - this->pending_input_time[0]).count();
+
+		this->stats.n_samples++;
+		this->stats.sum_latency += latency;
+		this->stats.max_latency = std::max(this->stats.max_latency, latency);
+	}
+
+	// the frames get one frame older
+	this->pending_input_time[0] = this->pending_input_time[1];
+	this->has_pending_input[0] = this->has_pending_input[1];
+	this->has_pending_input[1] = false;
+}
+
+// ---------------------------------------------------
+
+void InputSampler::report () const
+{
+	const Stats& s = this->stats;
+
+	dprintln("input: events=", s.n_events,
+		" presented=", s.n_samples,
+		" avg_latency_ms=", (s.n_samples > 0) ? (s.sum_latency / s.n_samples * 1e3) : 0.0,
+		" max_latency_ms=", s.max_latency * 1e3,
+		" avg_pump_interval_ms=", (s.n_pumps > 0) ? (s.sum_pump_interval / s.n_pumps * 1e3) : 0.0,
+		" max_pump_interval_ms=", s.max_pump_interval * 1e3
+		);
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
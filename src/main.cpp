@@ -1,4 +1,10 @@
 #include <thread>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <system_error>
+
+#include <cmath>
 
 #include <my-game-lib/my-game-lib.h>
 #include <my-game-lib/debug.h>
@@ -9,6 +15,15 @@
 #include <aurora/lib.h>
 #include <aurora/globals.h>
 #include <aurora/graphics.h>
+#include <aurora/render.h>
+#include <aurora/thread-pool.h>
+#include <aurora/render-backend.h>
+#include <aurora/asset-pack.h>
+#include <aurora/texture-streamer.h>
+#include <aurora/input.h>
+#include <aurora/physics.h>
+#include <aurora/memory-stats.h>
+#include <aurora/object-pool.h>
 #include <aurora/audio.h>
 #include <aurora/object.h>
 #include <aurora/world.h>
@@ -22,12 +37,19 @@ namespace Game
 // ---------------------------------------------------
 
 Main::Main (const InitConfig& cfg)
+	: frame_pacer(Config::precise_frame_pacing ? FramePacer::Mode::Precise : FramePacer::Mode::Legacy, Config::target_dt)
 {
 	this->state = State::Initializing;
 	this->cfg_params = cfg;
 
+	if (cfg.headless) {
+		// SDL's dummy drivers need neither a display nor a sound card
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+	}
+
 	game_lib = &MyGlib::Lib::init({
-		.graphics_type = MyGlib::Graphics::Manager::Type::Opengl,
+		.graphics_type = cfg.headless ? MyGlib::Graphics::Manager::Type::SDL : MyGlib::Graphics::Manager::Type::Opengl,
 		.window_name = "Project Aurora",
 		.window_width_px = cfg.window_width_px,
 		.window_height_px = cfg.window_height_px,
@@ -35,16 +57,31 @@ Main::Main (const InitConfig& cfg)
 	});
 
 	event_manager = &game_lib->get_event_manager();
+	input_sampler.start();
 	audio_manager = &game_lib->get_audio_manager();
 	renderer = &game_lib->get_graphics_manager();
 
+	if (cfg.headless)
+		render_backend = new NullRenderBackend();
+	else
+		render_backend = new OpenglRenderBackend(renderer);
+
 	std::random_device rd;
-	random_generator.seed( rd() );
+	random_service.set_seed( (static_cast<uint64_t>(rd()) << 32) | rd() );
+
+	// the calling thread also works, so we need one less worker
+	const uint32_t n_cores = std::thread::hardware_concurrency();
+	thread_pool = new ThreadPool((n_cores > 1) ? (n_cores - 1) : 0);
+
+	if (asset_files.open_pack(Config::asset_pack_fname))
+		dprintln("loading assets from ", Config::asset_pack_fname);
 
 	load_graphics();
 	load_audio();
 	load_objects();
 
+	render_pipeline = new RenderPipeline();
+
 	dprintln("chorono resolution ", (static_cast<float>(Clock::period::num) / static_cast<float>(Clock::period::den)));
 
 	this->world = nullptr;
@@ -62,7 +99,48 @@ Main::Main (const InitConfig& cfg)
 
 Main::~Main ()
 {
+	// joins the render thread before the world and its map are destroyed
+	delete render_pipeline;
+	render_pipeline = nullptr;
+
+	const auto& spell_pool = this->world->get_pool<SpellObject>();
+
+	dprintln("spell pool: constructed=", spell_pool.get_n_constructed(),
+		" chunk allocations=", spell_pool.get_n_chunk_allocations()
+		);
+
 	delete this->world;
+
+	texture_streamer.stop();
+
+	delete thread_pool;
+	thread_pool = nullptr;
+
+	if (this->cfg_params.headless) {
+		const auto& stats = static_cast<NullRenderBackend*>(render_backend)->get_ref_stats();
+
+		dprintln("headless render stats:",
+			" frames=", stats.n_frames,
+			" textures=", stats.n_textures,
+			" draws=", stats.n_draws,
+			" vertices=", stats.n_vertices,
+			" bytes=", stats.n_bytes
+			);
+	}
+
+	this->frame_pacer.report();
+	input_sampler.report();
+
+	dprintln("simulated ", this->n_simulation_steps, " steps in ", this->n_frames, " frames");
+
+	dprintln("heap allocations after ", Config::heap_stats_warmup_frames, " frames: ", this->n_steady_heap_allocations,
+		" in ", this->n_steady_frames_allocating, " frames");
+
+	delete render_backend;
+	render_backend = nullptr;
+
+	input_sampler.stop();
+
 	event_manager->quit().unsubscribe(this->event_quit_d);
 	event_manager->key_down().unsubscribe(this->event_key_down_d);
 	MyGlib::Lib::quit();
@@ -100,6 +178,14 @@ void Main::event_key_down_callback (const MyGlib::Event::KeyDown::Type& event)
 		case SDLK_ESCAPE:
 			this->alive = false;
 		break;
+
+		case SDLK_F1:
+			debug_draw.colliders = !debug_draw.colliders;
+		break;
+
+		case SDLK_F2:
+			debug_draw.sprite_boxes = !debug_draw.sprite_boxes;
+		break;
 	
 		default:
 			break;
@@ -108,37 +194,53 @@ void Main::event_key_down_callback (const MyGlib::Event::KeyDown::Type& event)
 
 // ---------------------------------------------------
 
+void Main::simulation_step (const float dt)
+{
+	this->world->store_previous_state();
+
+	simulation_clock.advance(dt);
+	timer.trigger_events();
+	interpolation_manager.process_interpolation(dt);
+
+	this->world->process_update(dt);
+	this->world->process_physics(dt);
+
+	this->n_simulation_steps++;
+}
+
+// ---------------------------------------------------
+
 void Main::run ()
 {
-	float real_dt, virtual_dt, required_dt, sleep_dt, busy_wait_dt, fps;
+	float real_dt, virtual_dt, required_dt, fps;
+
+	// simulation time not simulated yet, always less than Config::simulation_dt after the steps of a frame
+	float accumulator = 0.0f;
 
 	this->state = State::Playing;
 
 	real_dt = 0.0f;
 	virtual_dt = 0.0f;
 	required_dt = 0.0f;
-	sleep_dt = 0.0f;
-	busy_wait_dt = 0.0f;
 	fps = 0.0f;
 
 	while (this->alive) {
 		const ClockTime tbegin = Clock::now();
-		ClockTime tend;
-		ClockDuration elapsed;
+		const uint64_t n_heap_allocations_begin = get_n_heap_allocations();
 
-		renderer->wait_next_frame();
+		render_backend->wait_next_frame();
 
-		virtual_dt = (real_dt > Config::max_dt) ? Config::max_dt : real_dt;
+		if (this->cfg_params.fast_forward)
+			virtual_dt = Config::target_dt;
+		else
+			virtual_dt = (real_dt > Config::max_dt) ? Config::max_dt : real_dt;
 
-		timer.trigger_events();
-		interpolation_manager.process_interpolation(virtual_dt);
+		animation_track_manager.process(virtual_dt);
 
 	#if 0
 		dprintln("start new frame render target_dt=", Config::target_dt,
 			" required_dt=", required_dt,
 			" real_dt=", real_dt,
-			" sleep_dt=", sleep_dt,
-			" busy_wait_dt=", busy_wait_dt,
 			" virtual_dt=", virtual_dt,
 			" max_dt=", Config::max_dt,
 			" target_dt=", Config::target_dt,
@@ -146,21 +248,61 @@ void Main::run ()
 			);
 	#endif
 
+		texture_streamer.process();
+
+		// input is sampled as late as possible, right before the simulation
 		event_manager->process_events();
+		input_sampler.sample();
+
+		render_pipeline->begin_frame();
 
 		switch (this->state) {
 			case State::Playing:
-				this->world->process_update(virtual_dt);
-				this->world->process_physics(virtual_dt);
-				this->world->render(virtual_dt);
+				if constexpr (Config::fixed_timestep) {
+					uint32_t n_steps = 0;
+
+					accumulator += virtual_dt;
+
+					while (accumulator >= Config::simulation_dt && n_steps < Config::max_simulation_steps_per_frame) {
+						this->simulation_step(Config::simulation_dt);
+						accumulator -= Config::simulation_dt;
+						n_steps++;
+					}
+
+					if (accumulator >= Config::simulation_dt)
+						accumulator = std::fmod(accumulator, Config::simulation_dt);
+
+					this->world->render(virtual_dt, accumulator / Config::simulation_dt);
+				}
+				else {
+					this->simulation_step(virtual_dt);
+
+					// with a variable step the simulation is always up to date with the frame
+					this->world->render(virtual_dt, 1.0f);
+				}
 			break;
 			
 			default:
 				mylib_assert(0)
 		}
 
-		renderer->render();
-		renderer->update_screen();
+		render_pipeline->end_frame();
+
+		render_backend->render();
+		render_backend->update_screen();
+		input_sampler.frame_presented();
+
+		if (this->n_frames >= Config::heap_stats_warmup_frames) {
+			const uint64_t n_heap_allocations = get_n_heap_allocations() - n_heap_allocations_begin;
+
+			this->n_steady_heap_allocations += n_heap_allocations;
+			this->n_steady_frames_allocating += (n_heap_allocations > 0);
+		}
+
+		this->n_frames++;
+
+		if (this->cfg_params.max_frames > 0 && this->n_frames >= this->cfg_params.max_frames)
+			this->alive = false;
 
 		switch (this->state) {
 			case State::Playing:
@@ -171,33 +313,12 @@ void Main::run ()
 				mylib_assert(0)
 		}
 
-		const ClockTime trequired = Clock::now();
-		elapsed = trequired - tbegin;
-		required_dt = ClockDuration_to_float(elapsed);
-
-		if constexpr (Config::sleep_to_save_cpu) {
-			if (required_dt < Config::sleep_threshold) {
-				sleep_dt = Config::sleep_threshold - required_dt; // target sleep time
-				std::this_thread::sleep_for(float_to_ClockDuration(sleep_dt));
-			}
-		}
-		
-		const ClockTime tbefore_busy_wait = Clock::now();
-		elapsed = tbefore_busy_wait - trequired;
-		sleep_dt = ClockDuration_to_float(elapsed); // check exactly time sleeping
+		required_dt = ClockDuration_to_float(Clock::now() - tbegin);
 
-		do {
-			tend = Clock::now();
-			elapsed = tend - tbegin;
-			real_dt = ClockDuration_to_float(elapsed);
-
-			if constexpr (!Config::busy_wait_to_ensure_fps)
-				break;
-		} while (real_dt < Config::target_dt);
-
-		elapsed = tend - tbefore_busy_wait;
-		busy_wait_dt = ClockDuration_to_float(elapsed);
+		if (!this->cfg_params.fast_forward)
+			this->frame_pacer.wait(tbegin);
 
+		real_dt = ClockDuration_to_float(Clock::now() - tbegin);
 		fps = 1.0f / real_dt;
 	}
 }
@@ -210,11 +331,41 @@ void Main::run ()
 
 int main (int argc, char **argv)
 {
+	bool headless = false;
+	bool fast_forward = false;
+	uint32_t max_frames = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const std::string_view arg = argv[i];
+
+		if (arg == "--headless")
+			headless = true;
+		else if (arg == "--fast-forward")
+			fast_forward = true;
+		else if (arg == "--frames") {
+			const std::string_view value = ((i+1) < argc) ? argv[++i] : "";
+			const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), max_frames);
+
+			if (value.empty() || ec != std::errc() || ptr != (value.data() + value.size())) {
+				Game::dprintln("usage: --frames <number of frames>, got \"", value, "\"");
+				return EXIT_FAILURE;
+			}
+		}
+		else if (arg == "--benchmark-physics") {
+			// doesn't need the window nor the assets
+			Game::run_physics_benchmark(4096, 200);
+			return EXIT_SUCCESS;
+		}
+	}
+
 	try {
 		Game::Main *game = Game::Main::load({
 			.window_width_px = 1920,
 			.window_height_px = 1080,
-			.fullscreen = false
+			.fullscreen = false,
+			.headless = headless,
+			.fast_forward = fast_forward,
+			.max_frames = max_frames
 		});
 		
 		game->run();
@@ -0,0 +1,109 @@
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/mapped-file.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+MappedFile::~MappedFile ()
+{
+	this->close();
+}
+
+// ---------------------------------------------------
+
+#if defined(__unix__) || defined(__APPLE__)
+
+bool MappedFile::open (const char *fname)
+{
+	this->close();
+
+	const int fd = ::open(fname, O_RDONLY);
+
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	void *ptr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	// the mapping keeps a reference to the file
+	::close(fd);
+
+	if (ptr == MAP_FAILED)
+		return false;
+
+	this->data = static_cast<std::byte*>(ptr);
+	this->size = st.st_size;
+
+	return true;
+}
+
+void MappedFile::close ()
+{
+	if (this->data != nullptr)
+		munmap(this->data, this->size);
+
+	this->data = nullptr;
+	this->size = 0;
+}
+
+#else
+
+bool MappedFile::open (const char *fname)
+{
+	this->close();
+
+	std::ifstream file(fname, std::ios::binary | std::ios::ate);
+
+	if (!file)
+		return false;
+
+	const std::streamsize file_size = file.tellg();
+
+	if (file_size <= 0)
+		return false;
+
+	this->storage = std::make_unique_for_overwrite<std::byte[]>(file_size);
+	file.seekg(0);
+
+	if (!file.read(reinterpret_cast<char*>(this->storage.get()), file_size)) {
+		this->storage.reset();
+		return false;
+	}
+
+	this->data = this->storage.get();
+	this->size = file_size;
+
+	return true;
+}
+
+void MappedFile::close ()
+{
+	this->storage.reset();
+	this->data = nullptr;
+	this->size = 0;
+}
+
+#endif
+
+// ---------------------------------------------------
+
+} // end namespace Game
@@ -0,0 +1,55 @@
+#include <atomic>
+#include <new>
+
+#include <cstdlib>
+
+#include <aurora/memory-stats.h>
+
+// ---------------------------------------------------
+
+static std::atomic<uint64_t> n_heap_allocations = 0;
+
+// ---------------------------------------------------
+
+/*
+	The array and nothrow versions call these by default.
+	Over-aligned allocations are not counted.
+*/
+
+void* operator new (const std::size_t size)
+{
+	n_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	void *p = std::malloc((size > 0) ? size : 1);
+
+	if (p == nullptr) [[unlikely]]
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void operator delete (void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete (void *p, const std::size_t) noexcept
+{
+	std::free(p);
+}
+
+// ---------------------------------------------------
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+uint64_t get_n_heap_allocations () noexcept
+{
+	return n_heap_allocations.load(std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
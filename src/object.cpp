@@ -1,7 +1,8 @@
-#include <unordered_map>
 #include <utility>
 #include <numbers>
 #include <numeric>
+#include <optional>
+#include <array>
 
 #include <cmath>
 
@@ -17,8 +18,12 @@
 #include <aurora/globals.h>
 #include <aurora/graphics.h>
 #include <aurora/object.h>
+#include <aurora/blueprint.h>
 #include <aurora/world.h>
+#include <aurora/effects.h>
+#include <aurora/render.h>
 #include <aurora/audio.h>
+#include <aurora/input.h>
 
 
 namespace Game
@@ -33,90 +38,20 @@ namespace Config
 	inline constexpr float spell_speed = 4.0f;
 	inline constexpr float spell_angular_speed = Mylib::Math::degrees_to_radians(270.0f);
 	inline constexpr float spell_life_span = 2.0f;
-}
-
-// ---------------------------------------------------
-
-struct BluePrintStaticObjectSprite {
-	Object::Subtype subtype;
-	TextureDescriptor& texture;
-	Vector3 collider_size;
-	Vector2 sprite_size;
-	Vector2 sprite_source_anchor;
-	Vector3 sprite_dest_anchor;
-};
-
-// ---------------------------------------------------
 
-struct BluePrintStaticObjectAnimation {
-	Object::Subtype subtype;
-	std::span<TextureDescriptor> textures;
-	Vector3 collider_size;
-	Vector2 sprite_size;
-	Vector2 sprite_source_anchor;
-	Vector3 sprite_dest_anchor;
-	float frame_duration;
-	bool die_after_animation;
-};
+	// a dying enemy bursts into a small cluster of explosions
+	inline constexpr uint32_t enemy_death_explosions = 3;
+	inline constexpr Vector enemy_death_explosion_spread = Vector(0.3, 0.3, 0);
 
-// ---------------------------------------------------
-
-static std::unordered_map<uint32_t, BluePrintStaticObjectSprite> blueprints_static_object_sprite;
-static std::unordered_map<uint32_t, BluePrintStaticObjectAnimation> blueprints_static_object_animation;
+	inline constexpr float enemy_speed = 1.0f;
+	inline constexpr float enemy_patrol_delay = 1.0f; // wait at each patrol point
+}
 
 // ---------------------------------------------------
 
 void load_objects ()
 {
-	// tree_00
-	{
-		const auto [it, success] = blueprints_static_object_sprite.insert({
-			std::to_underlying(Object::Subtype::Tree_00),
-			{
-				.subtype = Object::Subtype::Tree_00,
-				.texture = Texture::tree_00,
-				.collider_size = Vector3(1, 1, 4),
-				.sprite_size = Vector2(4, 4),
-				.sprite_source_anchor = Vector2(0, -0.5),
-				.sprite_dest_anchor = Vector3(0, 0, -2)
-			}
-		});
-		mylib_assert_msg(success, "failed to insert blueprint for Tree_00");
-	}
-
-	// castle_00
-	{
-		const auto [it, success] = blueprints_static_object_sprite.insert({
-			std::to_underlying(Object::Subtype::Castle_00),
-			{
-				.subtype = Object::Subtype::Castle_00,
-				.texture = Texture::castle_00,
-				.collider_size = Vector3(5, 5, 5),
-				.sprite_size = Vector2(5.5, 5.5),
-				.sprite_source_anchor = Vector2(0, -0.5),
-				.sprite_dest_anchor = Vector3(-1.7, -1.7, -2.5)
-			}
-		});
-		mylib_assert_msg(success, "failed to insert blueprint for Castle_00");
-	}
-
-	// explosion
-	{
-		const auto [it, success] = blueprints_static_object_animation.insert({
-			std::to_underlying(Object::Subtype::Explosion),
-			{
-				.subtype = Object::Subtype::Explosion,
-				.textures = Texture::matrix_explosion.to_span(),
-				.collider_size = Vector3(0, 0, 0), // no collider
-				.sprite_size = Vector2(2, 2),
-				.sprite_source_anchor = Vector2(0, 0),
-				.sprite_dest_anchor = Vector3(0, 0, 0),
-				.frame_duration = 0.05f,
-				.die_after_animation = true
-			}
-		});
-		mylib_assert_msg(success, "failed to insert blueprint for Explosion");
-	}
+	blueprint_registry.load(Config::blueprints_fname);
 }
 
 // ---------------------------------------------------
@@ -127,66 +62,31 @@ std::unique_ptr<StaticObjectSprite> build_static_object_sprite (
 	const Vector& pos
 	)
 {
-	const auto it = blueprints_static_object_sprite.find({std::to_underlying(subtype)});
-	mylib_assert_msg(it != blueprints_static_object_sprite.end(), "blueprint not found for ", subtype);
-
-	const auto& blueprint = it->second;
+	const Blueprint& blueprint = blueprint_registry.get(subtype);
 
 	auto r = std::make_unique<StaticObjectSprite>(
 		world,
 		blueprint.subtype,
 		pos,
-		blueprint.texture,
+		*blueprint.texture,
 		blueprint.sprite_size,
 		blueprint.sprite_source_anchor,
 		blueprint.sprite_dest_anchor
 	);
 
-	if (blueprint.collider_size != Vector3::zero())
-		r->get_colliders().push_back(Collider {
-			.object = r.get(),
-			.ds = Vector::zero(),
-			.size = blueprint.collider_size,
-			.id = 0
-		});
+	add_blueprint_collider(r.get(), blueprint);
 
 	return r;
 }
 
 // ---------------------------------------------------
 
-std::unique_ptr<StaticObjectAnimation> build_static_object_animation (
-	World *world,
-	const Object::Subtype subtype,
-	const Vector& pos
-	)
+void ObjectDeleter::operator() (Object *obj) const noexcept
 {
-	const auto it = blueprints_static_object_animation.find({std::to_underlying(subtype)});
-	mylib_assert_msg(it != blueprints_static_object_animation.end(), "blueprint not found for ", subtype);
-
-	const auto& blueprint = it->second;
-
-	auto r = std::make_unique<StaticObjectAnimation>(
-		world,
-		blueprint.subtype,
-		pos,
-		blueprint.textures,
-		blueprint.sprite_size,
-		blueprint.sprite_source_anchor,
-		blueprint.sprite_dest_anchor,
-		blueprint.frame_duration,
-		blueprint.die_after_animation
-	);
-
-	if (blueprint.collider_size != Vector3::zero())
-		r->get_colliders().push_back(Collider {
-			.object = r.get(),
-			.ds = Vector::zero(),
-			.size = blueprint.collider_size,
-			.id = 0
-		});
-
-	return r;
+	if (ObjectPoolBase *pool = obj->get_pool())
+		pool->recycle(obj);
+	else
+		delete obj;
 }
 
 // ---------------------------------------------------
@@ -208,63 +108,21 @@ void Object::collision (const Collider& my_collider, const Collider& other_colli
 
 // ---------------------------------------------------
 
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
-
 void StaticObject::render_colliders (const Color& color) const
 {
 	for (const Collider& collider : this->colliders)
 		collider.render(color);
 }
 
-#endif
-
 // ---------------------------------------------------
 
 void StaticObjectSprite::render (const float dt)
 {
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
-	this->render_colliders(Colors::red);
-#endif
-
 	this->sprite.render();
 }
 
 // ---------------------------------------------------
 
-void StaticObjectAnimation::render (const float dt)
-{
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
-	this->render_colliders(Colors::red);
-#endif
-
-	this->animation.render(dt);
-}
-
-// ---------------------------------------------------
-
-StaticObjectAnimation::StaticObjectAnimation (World *world_, const Subtype subtype_, const Point& pos_, const std::span<TextureDescriptor> textures_, const Vector2& size_, const Vector2 source_anchor_, const Vector3 dest_anchor_, const float frame_duration_, const bool die_after_animation)
-	: StaticObject(world_, subtype_, pos_),
-		animation(this, textures_, size_, source_anchor_, dest_anchor_, frame_duration_)
-{
-	if (die_after_animation) {
-		this->animation_event_descriptor = this->animation.get_ref_event_handler().subscribe( Mylib::Event::make_callback_lambda<FooEvent>(
-				[this] (const SpriteAnimation::Event& event) {
-					this->world->remove_object_next_frame(this);
-				}
-			));
-	}
-}
-
-// ---------------------------------------------------
-
-StaticObjectAnimation::~StaticObjectAnimation ()
-{
-	if (this->animation_event_descriptor.is_valid())
-		this->animation.get_ref_event_handler().unsubscribe(this->animation_event_descriptor);
-}
-
-// ---------------------------------------------------
-
 PlayerObject::PlayerObject (World *world_, const Point& pos_)
 	: DynamicObject(world_, Subtype::Player, pos_),
 	  animations(
@@ -307,52 +165,48 @@ PlayerObject::~PlayerObject ()
 
 void PlayerObject::render (const float dt)
 {
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
-	this->render_colliders(Colors::red);
-#endif
-
 	this->animations.render(dt);
 }
 
 // ---------------------------------------------------
 
+/*
+	Direction of each combination of the keys in InputSampler::get_keys().
+	Down has priority over up, and right over left.
+	An empty entry means no movement, and the player keeps its last direction.
+*/
+
+static constexpr auto player_directions = [] () {
+	using enum PlayerObject::Direction;
+
+	std::array<std::optional<PlayerObject::Direction>, 16> table;
+
+	for (uint32_t keys = 0; keys < table.size(); keys++) {
+		const bool right = keys & InputSampler::Right;
+		const bool left = keys & InputSampler::Left;
+
+		if (keys & InputSampler::Down)
+			table[keys] = right ? SouthEast : (left ? SouthWest : South);
+		else if (keys & InputSampler::Up)
+			table[keys] = right ? NorthEast : (left ? NorthWest : North);
+		else if (right)
+			table[keys] = East;
+		else if (left)
+			table[keys] = West;
+	}
+
+	return table;
+} ();
+
 void PlayerObject::update (const float dt)
 {
 	constexpr float speed = 5.0;
 
-	constexpr auto key_down = SDL_SCANCODE_DOWN;
-	constexpr auto key_up = SDL_SCANCODE_UP;
-	constexpr auto key_left = SDL_SCANCODE_LEFT;
-	constexpr auto key_right = SDL_SCANCODE_RIGHT;
+	const std::optional<Direction> direction_ = player_directions[input_sampler.get_keys()];
+	const bool stop = !direction_.has_value();
 
-	bool stop = false;
-
-	if (event_manager->is_key_down(key_down)) {
-		if (event_manager->is_key_down(key_right))
-			this->direction = Direction::SouthEast;
-		else if (event_manager->is_key_down(key_left))
-			this->direction = Direction::SouthWest;
-		else
-			this->direction = Direction::South;
-	}
-	else if (event_manager->is_key_down(key_up)) {
-		if (event_manager->is_key_down(key_right))
-			this->direction = Direction::NorthEast;
-		else if (event_manager->is_key_down(key_left))
-			this->direction = Direction::NorthWest;
-		else
-			this->direction = Direction::North;
-	}
-	else {
-		if (event_manager->is_key_down(key_right))
-			this->direction = Direction::East;
-		else if (event_manager->is_key_down(key_left))
-			this->direction = Direction::West;
-		else {
-			// keep last direction
-			stop = true;
-		}
-	}
+	if (!stop)
+		this->direction = *direction_;
 
 	if (!stop) {
 		const Vector2 new_vel = Mylib::Math::with_length( direction_vector[ std::to_underlying(this->direction) ], speed);
@@ -384,7 +238,7 @@ void PlayerObject::event_key_down_callback (const MyGlib::Event::KeyDown::Type&
 			const Vector2 direction = direction_vector[ std::to_underlying(this->direction) ];
 			const Vector2 ds = Mylib::Math::with_length(direction, distance);
 			const Vector pos = this->get_ref_pos() + Vector(ds);
-			this->world->add_object( std::make_unique<SpellObject>(this->world, pos, Vector(direction)) );
+			this->world->add_pooled_object<SpellObject>(pos, Vector(direction));
 			audio_manager->play_audio(Audio::spell);
 		}
 		break;
@@ -398,6 +252,7 @@ void PlayerObject::event_key_down_callback (const MyGlib::Event::KeyDown::Type&
 
 EnemyObject::EnemyObject (World *world_, const std::initializer_list<Point2> positions)
 	: DynamicObject(world_, Subtype::Enemy),
+	  patrol(positions),
 	  sprite(
 	      this,
 	      Texture::enemy_00,
@@ -413,64 +268,45 @@ EnemyObject::EnemyObject (World *world_, const std::initializer_list<Point2> pos
 		.id = 0
 	});
 
-	this->coroutine = [] (EnemyObject *enemy, const std::initializer_list<Point2> positions__) -> Coroutine {
-		boost::container::static_vector<Point2, 8> positions = positions__;
-		EnemyObject& self = *enemy;
-		auto it_previous_pos = positions.begin();
-		auto it_next_position = positions.begin();
-		constexpr float speed = 1.0f;
-		constexpr float delay = 1.0f;
-
-		while (true) {
-			it_next_position++;
-
-			if (it_next_position == positions.end())
-				it_next_position = positions.begin();
-			
-			const Point2& previous_pos = *it_previous_pos;
-			const Point2& next_pos = *it_next_position;
-
-			const float distance = Mylib::Math::distance(previous_pos, next_pos);
-			const float time = distance / speed;
-
-//			dprintln("interpolating from ", previous_pos, " to ", next_pos, " in ", time, " seconds");
-			
-			interpolation_manager.interpolate_linear(time, &self.get_ref_pos().x, previous_pos.x, next_pos.x);
-			co_await interpolation_manager.coroutine_wait_interpolate_linear(time, &self.get_ref_pos().y, previous_pos.y, next_pos.y);
-//			dprintln("interpolating done, sleeping...");
-			co_await timer.coroutine_wait(float_to_ClockDuration(delay));
-
-			it_previous_pos = it_next_position;
-		}
-	}(this, positions);
-
-	Mylib::initialize_coroutine(this->coroutine);
-}
-
-// ---------------------------------------------------
-
-EnemyObject::~EnemyObject ()
-{
-	timer.unregister_coroutine(this->coroutine);
-	interpolation_manager.unregister_coroutine(this->coroutine);
-	this->coroutine.handler.destroy();
+	mylib_assert_msg(!this->patrol.empty(), "enemy without patrol points");
 }
 
 // ---------------------------------------------------
 
 void EnemyObject::render (const float dt)
 {
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
-	this->render_colliders(Colors::red);
-#endif
-
 	this->sprite.render();
 }
 
 // ---------------------------------------------------
 
+/*
+	The patrol is advanced here instead of by the global timer and
+	interpolation manager, so nothing outside the enemy keeps a pointer
+	into it.
+*/
+
 void EnemyObject::update (const float dt)
 {
+	const uint32_t n = this->patrol.size();
+	const Point2& from = this->patrol[this->patrol_leg];
+	const Point2& to = this->patrol[(this->patrol_leg + 1) % n];
+	const float leg_time = Mylib::Math::distance(from, to) / Config::enemy_speed;
+
+	this->patrol_elapsed += dt;
+
+	// walks the leg, then waits at its end
+	const Point2 patrol_pos = (this->patrol_elapsed < leg_time)
+		? from + (to - from) * (this->patrol_elapsed / leg_time)
+		: to;
+
+	this->pos.x = patrol_pos.x;
+	this->pos.y = patrol_pos.y;
+
+	if (this->patrol_elapsed >= (leg_time + Config::enemy_patrol_delay)) {
+		this->patrol_leg = (this->patrol_leg + 1) % n;
+		this->patrol_elapsed = 0;
+	}
 }
 
 // ---------------------------------------------------
@@ -479,12 +315,12 @@ void EnemyObject::collision (const Collider& my_collider, const Collider& other_
 {
 	const Object *other_object = other_collider.object;
 
+	// several spells may hit the enemy in the same step, it only dies once
+	if (this->get_removal_pending())
+		return;
+
 	if (other_object->get_type() == Object::Type::Spell) { // die
-		auto *explosion_obj = static_cast<StaticObjectAnimation*>( this->world->add_object( build_static_object_animation(
-			this->world,
-			Object::Subtype::Explosion,
-			this->get_value_pos()
-			)));
+		this->world->get_ref_effects().emit_scattered(EffectType::Explosion, this->get_value_pos(), Config::enemy_death_explosion_spread, Config::enemy_death_explosions);
 		this->world->remove_object_next_frame(this);
 		audio_manager->play_audio(Audio::enemy_death);
 	}
@@ -494,9 +330,8 @@ void EnemyObject::collision (const Collider& my_collider, const Collider& other_
 
 SpellObject::SpellObject (World *world_, const Point& pos_, const Vector& direction_)
 	: DynamicObject(world_, Subtype::Spell, pos_),
-	  cube(Config::spell_size),
-	  color_interpolator(Config::spell_color_time, &this->color, Colors::random(random_generator), Colors::random(random_generator)),
-	  axis(random_vector<Vector3>()),
+	  color_interpolator(Config::spell_color_time, &this->color, Colors::random(gameplay_random()), Colors::random(gameplay_random())),
+	  axis(Mylib::Math::normalize(random_vector<Vector3>())),
 	  angle(0.0f)
 {
 	this->colliders.push_back(Collider {
@@ -507,43 +342,36 @@ SpellObject::SpellObject (World *world_, const Point& pos_, const Vector& direct
 	});
 
 	this->vel = Mylib::Math::with_length(direction_, Config::spell_speed);
-
-	this->timer_descriptor = timer.schedule_event(Clock::now() + float_to_ClockDuration(Config::spell_life_span), Mylib::Event::make_callback_lambda<Timer::Event>(
-		[this] (const Timer::Event& event) {
-			this->world->remove_object_next_frame(this);
-		}));
-}
-
-// ---------------------------------------------------
-
-SpellObject::~SpellObject ()
-{
-	if (this->timer_descriptor.is_valid()) {
-		timer.unschedule_event(this->timer_descriptor);
-	}
 }
 
 // ---------------------------------------------------
 
 void SpellObject::render (const float dt)
 {
-#ifdef AURORA_DEBUG_ENABLE_RENDER_COLLIDERS__
-	this->render_colliders(Colors::red);
-#endif
-
 	this->angle = std::fmod(this->angle + Config::spell_angular_speed * dt, Mylib::Math::degrees_to_radians(fp(360)));
-	this->cube.rotate(this->axis, this->angle);
 
 	if (!this->color_interpolator(dt))
-		Mylib::reconstruct(this->color_interpolator, Config::spell_color_time, &this->color, this->color, Colors::random(random_generator));
-
-	renderer->draw_cube3D(this->cube, this->get_ref_pos(), this->color);
+		Mylib::reconstruct(this->color_interpolator, Config::spell_color_time, &this->color, this->color, Colors::random(gameplay_random()));
+
+	render_pipeline->get_recording_snapshot().cubes.push_back( CubeInstance {
+		.previous_pos = this->get_ref_previous_pos(),
+		.pos = this->get_ref_pos(),
+		.axis = this->axis,
+		.angle = this->angle,
+		.size = Config::spell_size,
+		.color = this->color
+	} );
 }
 
 // ---------------------------------------------------
 
 void SpellObject::update (const float dt)
 {
+	// counted here instead of with a timer, so spawning a spell doesn't register anything
+	this->age += dt;
+
+	if (this->age >= Config::spell_life_span)
+		this->world->remove_object_next_frame(this);
 }
 
 // ---------------------------------------------------
@@ -0,0 +1,236 @@
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+#include <cstddef>
+
+#include <cmath>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/physics.h>
+#include <aurora/collision.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+void sweep_and_prune (std::vector<BroadphaseBox>& boxes, std::vector<BroadphasePair>& pairs)
+{
+	std::sort(boxes.begin(), boxes.end(), [] (const BroadphaseBox& a, const BroadphaseBox& b) {
+		return a.min_x < b.min_x;
+	});
+
+	for (uint32_t i = 0; i < boxes.size(); i++) {
+		// strict, as test_collision: boxes that only touch don't collide
+		for (uint32_t j = i + 1; j < boxes.size() && boxes[j].min_x < boxes[i].max_x; j++)
+			pairs.push_back( BroadphasePair { .a = boxes[i].id, .b = boxes[j].id } );
+	}
+}
+
+// ---------------------------------------------------
+
+/*
+	Compares the Vec4 collision test against the scalar code on
+	my-game-lib's Vector, and the sweep-and-prune broadphase against
+	testing every pair of objects, as the physics step used to work.
+*/
+
+// stands for a heap allocated DynamicObject: the hot kinematic state sits between cold data
+struct BenchmarkObject {
+	std::string name;
+	std::array<std::byte, 256> cold;
+	Vector pos;
+	Vector vel;
+};
+
+static std::pair<bool, Vector> check_collision_scalar (const Vector& a_pos, const Vector& a_size, const Vector& b_pos, const Vector& b_size) noexcept
+{
+	Vector collision_vector;
+
+	const Vector distance = b_pos - a_pos;
+	const Vector target_distance = a_size / fp(2) + b_size / fp(2);
+
+	const bool colliding_x = std::abs(distance.x) < target_distance.x;
+	collision_vector.x = std::copysign(target_distance.x - std::abs(distance.x), distance.x);
+
+	const bool colliding_y = std::abs(distance.y) < target_distance.y;
+	collision_vector.y = std::copysign(target_distance.y - std::abs(distance.y), distance.y);
+
+	const bool colliding_z = std::abs(distance.z) < target_distance.z;
+	collision_vector.z = std::copysign(target_distance.z - std::abs(distance.z), distance.z);
+
+	return std::pair<bool, Vector>(colliding_x && colliding_y && colliding_z, collision_vector);
+}
+
+template <typename Function>
+static double measure_ns (const uint64_t n_operations, Function&& function)
+{
+	const ClockTime begin = Clock::now();
+	function();
+	const ClockTime end = Clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(n_operations);
+}
+
+void run_physics_benchmark (const uint32_t n_objects, const uint32_t n_iterations)
+{
+	constexpr float dt = 1.0f / 60.0f;
+	constexpr uint32_t n_obstacles = 64;
+
+	/*
+		Fixed streams, so every run benchmarks the same objects.
+		The obstacles and the shuffle have their own sub-streams, so changing
+		the number of objects doesn't change them.
+	*/
+	RandomGenerator objects_gen = random_service.make_stream(RandomService::System::Benchmark, 0);
+	RandomGenerator obstacles_gen = random_service.make_stream(RandomService::System::Benchmark, 1);
+	RandomGenerator shuffle_gen = random_service.make_stream(RandomService::System::Benchmark, 2);
+
+	std::vector<Vector> scalar_pos(n_objects), scalar_vel(n_objects), scalar_size(n_objects);
+	std::vector<ColliderBox> simd_boxes(n_objects);
+
+	objects_gen.fill_vectors<Vector>(scalar_pos, Vector(0, 0, 0), Vector(100, 100, 10));
+	objects_gen.fill_vectors<Vector>(scalar_vel, Vector(-5, -5, 0), Vector(5, 5, 5));
+	objects_gen.fill_vectors<Vector>(scalar_size, Vector(0.2, 0.2, 0.2), Vector(2, 2, 2));
+
+	for (uint32_t i = 0; i < n_objects; i++)
+		simd_boxes[i] = ColliderBox { .center = Vec4(scalar_pos[i]), .half_size = Vec4(scalar_size[i] / fp(2)) };
+
+	std::vector<Vector> obstacle_pos(n_obstacles), obstacle_size(n_obstacles);
+	std::vector<ColliderBox> obstacle_boxes(n_obstacles);
+
+	obstacles_gen.fill_vectors<Vector>(obstacle_pos, Vector(0, 0, 0), Vector(100, 100, 10));
+	obstacles_gen.fill_vectors<Vector>(obstacle_size, Vector(1, 1, 1), Vector(10, 10, 10));
+
+	for (uint32_t i = 0; i < n_obstacles; i++)
+		obstacle_boxes[i] = ColliderBox { .center = Vec4(obstacle_pos[i]), .half_size = Vec4(obstacle_size[i] / fp(2)) };
+
+	// the integration moves the objects, so the collision tests use copies of the initial positions
+	const std::vector<Vector> scalar_box_pos = scalar_pos;
+
+	// objects visited in shuffled order, like heap objects allocated over a whole session
+	std::vector< std::unique_ptr<BenchmarkObject> > objects(n_objects);
+
+	for (uint32_t i = 0; i < n_objects; i++)
+		objects[i] = std::make_unique<BenchmarkObject>( BenchmarkObject { .name = {}, .cold = {}, .pos = scalar_pos[i], .vel = scalar_vel[i] } );
+
+	std::shuffle(objects.begin(), objects.end(), shuffle_gen);
+
+	const uint64_t n_integrations = static_cast<uint64_t>(n_objects) * n_iterations;
+	const uint64_t n_tests = n_integrations * n_obstacles;
+
+	const double scalar_integration_ns = measure_ns(n_integrations, [&] () {
+		for (uint32_t it = 0; it < n_iterations; it++) {
+			for (uint32_t i = 0; i < n_objects; i++) {
+				scalar_pos[i] += scalar_vel[i] * dt + Config::gravity * dt * dt / fp(2);
+				scalar_vel[i] += Config::gravity * dt;
+			}
+		}
+	});
+
+	// what World::process_physics does
+	const double objects_integration_ns = measure_ns(n_integrations, [&] () {
+		for (uint32_t it = 0; it < n_iterations; it++) {
+			for (auto& obj : objects) {
+				obj->pos += obj->vel * dt + Config::gravity * dt * dt / fp(2);
+				obj->vel += Config::gravity * dt;
+			}
+		}
+	});
+
+	uint64_t scalar_hits = 0;
+	float scalar_sum = 0;
+
+	const double scalar_collision_ns = measure_ns(n_tests, [&] () {
+		for (uint32_t it = 0; it < n_iterations; it++) {
+			for (uint32_t i = 0; i < n_objects; i++) {
+				for (uint32_t j = 0; j < n_obstacles; j++) {
+					const auto [colliding, ds] = check_collision_scalar(obstacle_pos[j], obstacle_size[j], scalar_box_pos[i], scalar_size[i]);
+					scalar_hits += colliding;
+					scalar_sum += ds.x;
+				}
+			}
+		}
+	});
+
+	uint64_t simd_hits = 0;
+	Vec4 simd_sum = Vec4::zero();
+
+	const double simd_collision_ns = measure_ns(n_tests, [&] () {
+		for (uint32_t it = 0; it < n_iterations; it++) {
+			for (uint32_t i = 0; i < n_objects; i++) {
+				for (uint32_t j = 0; j < n_obstacles; j++) {
+					Vec4 ds;
+					simd_hits += test_collision(obstacle_boxes[j], simd_boxes[i], ds);
+					simd_sum += ds;
+				}
+			}
+		}
+	});
+
+	// object to object collisions of a whole step, as World::process_object_collision
+	uint64_t all_pairs_hits = 0;
+
+	const double all_pairs_ns = measure_ns(n_integrations, [&] () {
+		for (uint32_t it = 0; it < n_iterations; it++) {
+			for (uint32_t i = 0; i < n_objects; i++) {
+				for (uint32_t j = i + 1; j < n_objects; j++) {
+					Vec4 ds;
+					all_pairs_hits += test_collision(simd_boxes[i], simd_boxes[j], ds);
+				}
+			}
+		}
+	});
+
+	std::vector<BroadphaseBox> broadphase_boxes;
+	std::vector<BroadphasePair> broadphase_pairs;
+	uint64_t broadphase_hits = 0;
+	uint64_t n_broadphase_pairs = 0;
+
+	const double broadphase_ns = measure_ns(n_integrations, [&] () {
+		for (uint32_t it = 0; it < n_iterations; it++) {
+			broadphase_boxes.clear();
+			broadphase_pairs.clear();
+
+			for (uint32_t i = 0; i < n_objects; i++) {
+				const float half_x = scalar_size[i].x / fp(2);
+				broadphase_boxes.push_back( BroadphaseBox { .min_x = scalar_box_pos[i].x - half_x, .max_x = scalar_box_pos[i].x + half_x, .id = i } );
+			}
+
+			sweep_and_prune(broadphase_boxes, broadphase_pairs);
+
+			for (const BroadphasePair& pair : broadphase_pairs) {
+				Vec4 ds;
+				broadphase_hits += test_collision(simd_boxes[pair.a], simd_boxes[pair.b], ds);
+			}
+
+			n_broadphase_pairs += broadphase_pairs.size();
+		}
+	});
+
+	dprintln("physics benchmark: objects=", n_objects, " iterations=", n_iterations);
+
+#ifndef __OPTIMIZE__
+	dprintln("  warning: not an optimized build, the results are meaningless (build with RELEASE=1)");
+#endif
+	dprintln("  integration scalar, contiguous vectors: ", scalar_integration_ns, " ns/object");
+	dprintln("  integration scalar, heap objects:       ", objects_integration_ns, " ns/object");
+	dprintln("  collision scalar:   ", scalar_collision_ns, " ns/test, hits=", scalar_hits);
+	dprintln("  collision simd:     ", simd_collision_ns, " ns/test (", scalar_collision_ns / simd_collision_ns, "x), hits=", simd_hits);
+	dprintln("  object pairs, all:            ", all_pairs_ns, " ns/object, hits=", all_pairs_hits);
+	dprintln("  object pairs, sweep and prune: ", broadphase_ns, " ns/object (", all_pairs_ns / broadphase_ns, "x), hits=", broadphase_hits,
+	         ", candidates=", n_broadphase_pairs / n_iterations, " per step");
+
+	// keeps the compiler from discarding the results
+	dprintln("  checksum ", scalar_sum + simd_sum.to_array()[0], " ", scalar_pos[0], " ", objects[0]->pos);
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
@@ -0,0 +1,87 @@
+#include <aurora/random.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+RandomGenerator::RandomGenerator (uint64_t seed) noexcept
+{
+	// splitmix64
+	for (uint64_t& word : this->s) {
+		seed += 0x9E3779B97F4A7C15;
+		uint64_t z = seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+		word = z ^ (z >> 31);
+	}
+}
+
+// ---------------------------------------------------
+
+void RandomGenerator::jump (const std::array<uint64_t, 4>& polynomial) noexcept
+{
+	std::array<uint64_t, 4> r = { 0, 0, 0, 0 };
+
+	for (const uint64_t word : polynomial) {
+		for (int b = 0; b < 64; b++) {
+			if (word & (uint64_t(1) << b)) {
+				for (uint32_t i = 0; i < r.size(); i++)
+					r[i] ^= this->s[i];
+			}
+			(*this)();
+		}
+	}
+
+	this->s = r;
+}
+
+void RandomGenerator::jump () noexcept
+{
+	this->jump({ 0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C, 0xA9582618E03FC9AA, 0x39ABDC4529B1661C });
+}
+
+void RandomGenerator::long_jump () noexcept
+{
+	this->jump({ 0x76E15D3EFEFDCBBF, 0xC5004E441C522FB3, 0x77710069854EE241, 0x39109BB02ACBE635 });
+}
+
+// ---------------------------------------------------
+
+void RandomGenerator::fill_floats (const std::span<float> out, const float min, const float max) noexcept
+{
+	const float range = max - min;
+
+	for (float& v : out)
+		v = min + range * this->next_float();
+}
+
+// ---------------------------------------------------
+
+void RandomService::set_seed (const uint64_t seed_) noexcept
+{
+	this->seed = seed_;
+
+	for (uint32_t i = 0; i < n_systems; i++)
+		this->streams[i] = this->make_stream(static_cast<System>(i));
+}
+
+// ---------------------------------------------------
+
+RandomGenerator RandomService::make_stream (const System system, const uint32_t sub_stream) const noexcept
+{
+	RandomGenerator gen(this->seed);
+
+	for (uint32_t i = 0; i <= std::to_underlying(system); i++)
+		gen.long_jump();
+
+	for (uint32_t i = 0; i < sub_stream; i++)
+		gen.jump();
+
+	return gen;
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
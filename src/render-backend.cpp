@@ -0,0 +1,230 @@
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/globals.h>
+#include <aurora/render-backend.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+OpenglRenderBackend::OpenglRenderBackend (MyGlib::Graphics::Manager *renderer_)
+	: opengl_renderer(static_cast<MyGlib::Graphics::Opengl::Renderer*>(renderer_))
+{
+}
+
+// ---------------------------------------------------
+
+void OpenglRenderBackend::begin_texture_loading ()
+{
+	this->opengl_renderer->begin_texture_loading();
+}
+
+TextureDescriptor OpenglRenderBackend::load_texture (const char *fname)
+{
+	return this->opengl_renderer->load_texture(fname);
+}
+
+TextureDescriptor OpenglRenderBackend::load_texture (SDL_Surface *surface)
+{
+	return this->opengl_renderer->load_texture(surface);
+}
+
+void OpenglRenderBackend::end_texture_loading ()
+{
+	this->opengl_renderer->end_texture_loading();
+}
+
+Mylib::Matrix<TextureDescriptor> OpenglRenderBackend::split_texture (const TextureDescriptor& texture, const uint32_t nrows, const uint32_t ncols)
+{
+	return this->opengl_renderer->split_texture(texture, nrows, ncols);
+}
+
+TextureCoords OpenglRenderBackend::get_texture_coords (const TextureDescriptor& texture)
+{
+	using enum MyGlib::Graphics::Enums::TextureVertexPositionIndex;
+
+	const Opengl_TextureDescriptor *desc = texture.info->data.get_value<Opengl_TextureDescriptor*>();
+	const float depth = desc->atlas->texture_depth;
+
+	return TextureCoords {
+		.left_bottom = Vector(desc->tex_coords[LeftBottom].x, desc->tex_coords[LeftBottom].y, depth),
+		.right_bottom = Vector(desc->tex_coords[RightBottom].x, desc->tex_coords[RightBottom].y, depth),
+		.left_top = Vector(desc->tex_coords[LeftTop].x, desc->tex_coords[LeftTop].y, depth),
+		.right_top = Vector(desc->tex_coords[RightTop].x, desc->tex_coords[RightTop].y, depth)
+	};
+}
+
+// ---------------------------------------------------
+
+LightPointDescriptor OpenglRenderBackend::add_light_point_source (const Point& pos, const Color& color)
+{
+	return this->opengl_renderer->add_light_point_source(pos, color);
+}
+
+// ---------------------------------------------------
+
+void OpenglRenderBackend::setup_render_3D (const MyGlib::Graphics::RenderArgs3D& args)
+{
+	this->opengl_renderer->setup_render_3D(args);
+}
+
+template <typename Program>
+static auto alloc_program_vertices (Program& program, const uint32_t n_vertices)
+{
+	using Vertex = typename Program::Vertex;
+
+	if (n_vertices == 0)
+		return std::span<Vertex>();
+
+	auto vertices = program.alloc_vertices(n_vertices);
+
+	return std::span<Vertex>(vertices.data(), n_vertices);
+}
+
+std::span<GraphicsVertex> OpenglRenderBackend::alloc_triangles_texture (const uint32_t n_vertices)
+{
+	return alloc_program_vertices(*this->opengl_renderer->get_program_triangle_texture(), n_vertices);
+}
+
+std::span<ColorVertex> OpenglRenderBackend::alloc_triangles_color (const uint32_t n_vertices)
+{
+	return alloc_program_vertices(*this->opengl_renderer->get_program_triangle_color(), n_vertices);
+}
+
+std::span<LineVertex> OpenglRenderBackend::alloc_lines (const uint32_t n_vertices)
+{
+	return alloc_program_vertices(*this->opengl_renderer->get_program_line_color(), n_vertices);
+}
+
+// ---------------------------------------------------
+
+void OpenglRenderBackend::wait_next_frame ()
+{
+	this->opengl_renderer->wait_next_frame();
+}
+
+void OpenglRenderBackend::render ()
+{
+	this->opengl_renderer->render();
+}
+
+void OpenglRenderBackend::update_screen ()
+{
+	this->opengl_renderer->update_screen();
+}
+
+// ---------------------------------------------------
+
+void NullRenderBackend::begin_texture_loading ()
+{
+}
+
+TextureDescriptor NullRenderBackend::make_texture ()
+{
+	TextureDescriptor texture;
+	texture.info = reinterpret_cast<TextureInfo*>( &this->fake_texture_infos.emplace_back() );
+	return texture;
+}
+
+TextureDescriptor NullRenderBackend::load_texture (const char *fname)
+{
+	this->stats.n_textures++;
+	return this->make_texture();
+}
+
+TextureDescriptor NullRenderBackend::load_texture (SDL_Surface *surface)
+{
+	this->stats.n_textures++;
+	return this->make_texture();
+}
+
+void NullRenderBackend::end_texture_loading ()
+{
+}
+
+Mylib::Matrix<TextureDescriptor> NullRenderBackend::split_texture (const TextureDescriptor& texture, const uint32_t nrows, const uint32_t ncols)
+{
+	Mylib::Matrix<TextureDescriptor> frames(nrows, ncols);
+
+	for (TextureDescriptor& frame : frames.to_span())
+		frame = this->make_texture();
+
+	return frames;
+}
+
+TextureCoords NullRenderBackend::get_texture_coords (const TextureDescriptor& texture)
+{
+	return TextureCoords {
+		.left_bottom = Vector(0, 0, 0),
+		.right_bottom = Vector(1, 0, 0),
+		.left_top = Vector(0, 1, 0),
+		.right_top = Vector(1, 1, 0)
+	};
+}
+
+// ---------------------------------------------------
+
+LightPointDescriptor NullRenderBackend::add_light_point_source (const Point& pos, const Color& color)
+{
+	return LightPointDescriptor();
+}
+
+// ---------------------------------------------------
+
+void NullRenderBackend::setup_render_3D (const MyGlib::Graphics::RenderArgs3D& args)
+{
+}
+
+template <typename Vertex>
+std::span<Vertex> NullRenderBackend::alloc (std::vector<Vertex>& storage, const uint32_t n_vertices)
+{
+	if (n_vertices == 0)
+		return std::span<Vertex>();
+
+	// nobody reads the vertices, so every allocation can reuse the same memory
+	if (storage.size() < n_vertices)
+		storage.resize(n_vertices);
+
+	this->stats.n_draws++;
+	this->stats.n_vertices += n_vertices;
+	this->stats.n_bytes += n_vertices * sizeof(Vertex);
+
+	return std::span<Vertex>(storage.data(), n_vertices);
+}
+
+std::span<GraphicsVertex> NullRenderBackend::alloc_triangles_texture (const uint32_t n_vertices)
+{
+	return this->alloc(this->triangles_texture, n_vertices);
+}
+
+std::span<ColorVertex> NullRenderBackend::alloc_triangles_color (const uint32_t n_vertices)
+{
+	return this->alloc(this->triangles_color, n_vertices);
+}
+
+std::span<LineVertex> NullRenderBackend::alloc_lines (const uint32_t n_vertices)
+{
+	return this->alloc(this->lines, n_vertices);
+}
+
+// ---------------------------------------------------
+
+void NullRenderBackend::wait_next_frame ()
+{
+}
+
+void NullRenderBackend::render ()
+{
+}
+
+void NullRenderBackend::update_screen ()
+{
+	this->stats.n_frames++;
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
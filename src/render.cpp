@@ -0,0 +1,338 @@
+#include <algorithm>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/globals.h>
+#include <aurora/graphics.h>
+#include <aurora/render.h>
+#include <aurora/thread-pool.h>
+#include <aurora/render-backend.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+static constexpr uint32_t n_vertices_per_wire_box = 24; // 12 edges
+static constexpr uint32_t n_vertices_per_sprite_box = 8; // 4 edges
+
+// ---------------------------------------------------
+
+static void write_wire_box_vertices (const WireBox& box, const float alpha, LineVertex *out) noexcept
+{
+	const Vector h = box.size / fp(2);
+	const Point pos = interpolate_pos(box.previous_pos, box.pos, alpha);
+
+	const std::array<Vector, 8> corners = {
+		Vector(-h.x, -h.y, -h.z),
+		Vector(h.x, -h.y, -h.z),
+		Vector(h.x, h.y, -h.z),
+		Vector(-h.x, h.y, -h.z),
+		Vector(-h.x, -h.y, h.z),
+		Vector(h.x, -h.y, h.z),
+		Vector(h.x, h.y, h.z),
+		Vector(-h.x, h.y, h.z)
+	};
+
+	static constexpr std::array<uint32_t, n_vertices_per_wire_box> edges = {
+		0, 1,  1, 2,  2, 3,  3, 0, // bottom
+		4, 5,  5, 6,  6, 7,  7, 4, // top
+		0, 4,  1, 5,  2, 6,  3, 7  // sides
+	};
+
+	for (const uint32_t corner : edges) {
+		LineVertex& vertex = *out++;
+		vertex.gvertex.pos = corners[corner];
+		vertex.gvertex.normal = Vector::zero();
+		vertex.offset = pos;
+		vertex.color = box.color;
+	}
+}
+
+// ---------------------------------------------------
+
+static void write_sprite_box_vertices (const SpriteInstance& sprite, const float alpha, LineVertex *out) noexcept
+{
+	using enum Sprite::PositionIndex;
+
+	const Point pos = interpolate_pos(sprite.previous_pos, sprite.pos, alpha);
+
+	const SpriteRegistry::Vertices& gv = sprite_registry.get(sprite.id);
+
+	// counter clock-wise
+
+	out[0].gvertex = gv[WestSouth].gvertex;
+	out[1].gvertex = gv[WestNorth].gvertex;
+	out[2].gvertex = gv[WestNorth].gvertex;
+	out[3].gvertex = gv[EastNorth].gvertex;
+	out[4].gvertex = gv[EastNorth].gvertex;
+	out[5].gvertex = gv[EastSouth].gvertex;
+	out[6].gvertex = gv[EastSouth].gvertex;
+	out[7].gvertex = gv[WestSouth].gvertex;
+
+	for (uint32_t i = 0; i < n_vertices_per_sprite_box; i++) {
+		out[i].offset = pos;
+		out[i].color = Colors::blue;
+	}
+}
+
+// ---------------------------------------------------
+
+DrawCounts count_draw_data (const RenderSnapshot& snapshot) noexcept
+{
+	const uint32_t n_sprites = snapshot.sprites.size();
+	const uint32_t n_sprite_boxes = snapshot.sprite_boxes ? n_sprites : 0;
+
+	return DrawCounts {
+		.n_triangles_texture = static_cast<uint32_t>(snapshot.terrain.size()) + n_sprites * Sprite::n_vertices,
+		.n_triangles_color = static_cast<uint32_t>(snapshot.cubes.size()) * n_vertices_per_cube,
+		.n_lines = static_cast<uint32_t>(snapshot.wire_boxes.size()) * n_vertices_per_wire_box + n_sprite_boxes * n_vertices_per_sprite_box
+	};
+}
+
+// ---------------------------------------------------
+
+/*
+	The draw data is split in sections (terrain, sprites, cubes, wire boxes
+	and sprite boxes), and each section in ranges of items.
+	Every item has a fixed number of vertices, so we know beforehand where
+	each range goes in the output buffers.
+	Threads write their ranges directly into the final buffers, so the result
+	is the same as a sequential build, regardless of the number of threads.
+*/
+
+void build_draw_data (const RenderSnapshot& snapshot, const DrawTargets& targets)
+{
+	enum Section : uint32_t {
+		Terrain,
+		Sprites,
+		Cubes,
+		WireBoxes,
+		SpriteBoxes,
+		NumberOfSections
+	};
+
+	// number of items of each range
+	static constexpr std::array<uint32_t, NumberOfSections> grain = {
+		16384, // terrain vertices
+		1024,  // sprites
+		256,   // cubes
+		1024,  // wire boxes
+		1024   // sprite boxes
+	};
+
+	const float alpha = snapshot.alpha;
+
+	const std::array<uint32_t, NumberOfSections> n_items = {
+		static_cast<uint32_t>(snapshot.terrain.size()),
+		static_cast<uint32_t>(snapshot.sprites.size()),
+		static_cast<uint32_t>(snapshot.cubes.size()),
+		static_cast<uint32_t>(snapshot.wire_boxes.size()),
+		snapshot.sprite_boxes ? static_cast<uint32_t>(snapshot.sprites.size()) : 0
+	};
+
+	// textured triangles: terrain first, then sprites
+	// lines: wire boxes first, then sprite boxes
+
+	GraphicsVertex *terrain_out = targets.triangles_texture.data();
+	GraphicsVertex *sprites_out = terrain_out + n_items[Terrain];
+	ColorVertex *cubes_out = targets.triangles_color.data();
+	LineVertex *wire_boxes_out = targets.lines.data();
+	LineVertex *sprite_boxes_out = wire_boxes_out + n_items[WireBoxes] * n_vertices_per_wire_box;
+
+	std::array<uint32_t, NumberOfSections + 1> first_task;
+	first_task[0] = 0;
+
+	for (uint32_t section = 0; section < NumberOfSections; section++)
+		first_task[section + 1] = first_task[section] + (n_items[section] + grain[section] - 1) / grain[section];
+
+	auto job = [&] (const uint32_t task) {
+		uint32_t section = 0;
+
+		while (task >= first_task[section + 1])
+			section++;
+
+		const uint32_t begin = (task - first_task[section]) * grain[section];
+		const uint32_t end = std::min(begin + grain[section], n_items[section]);
+
+		switch (section) {
+			case Terrain:
+				std::copy(snapshot.terrain.begin() + begin, snapshot.terrain.begin() + end, terrain_out + begin);
+			break;
+
+			case Sprites:
+				for (uint32_t i = begin; i < end; i++) {
+					const SpriteInstance& sprite = snapshot.sprites[i];
+					sprite_registry.write_vertices(sprite.id, sprites_out + i * Sprite::n_vertices, interpolate_pos(sprite.previous_pos, sprite.pos, alpha));
+				}
+			break;
+
+			case Cubes:
+				for (uint32_t i = begin; i < end; i++)
+					write_cube_vertices(snapshot.cubes[i], alpha, cubes_out + i * n_vertices_per_cube);
+			break;
+
+			case WireBoxes:
+				for (uint32_t i = begin; i < end; i++)
+					write_wire_box_vertices(snapshot.wire_boxes[i], alpha, wire_boxes_out + i * n_vertices_per_wire_box);
+			break;
+
+			case SpriteBoxes:
+				for (uint32_t i = begin; i < end; i++)
+					write_sprite_box_vertices(snapshot.sprites[i], alpha, sprite_boxes_out + i * n_vertices_per_sprite_box);
+			break;
+
+			default:
+				mylib_assert(0)
+		}
+	};
+
+	thread_pool->run(first_task[NumberOfSections], job);
+}
+
+// ---------------------------------------------------
+
+RenderPipeline::RenderPipeline ()
+{
+	if constexpr (Config::threaded_render)
+		this->worker = std::thread(&RenderPipeline::worker_loop, this);
+}
+
+// ---------------------------------------------------
+
+RenderPipeline::~RenderPipeline ()
+{
+	if constexpr (Config::threaded_render) {
+		{
+			std::lock_guard lock(this->mutex);
+			this->quit = true;
+		}
+
+		this->cond_request.notify_one();
+		this->worker.join();
+	}
+}
+
+// ---------------------------------------------------
+
+void RenderPipeline::worker_loop ()
+{
+	while (true) {
+		uint32_t index;
+
+		{
+			std::unique_lock lock(this->mutex);
+			this->cond_request.wait(lock, [this] { return this->build_pending || this->quit; });
+
+			if (!this->build_pending)
+				return;
+
+			index = this->build_index;
+		}
+
+		this->build(index);
+
+		{
+			std::lock_guard lock(this->mutex);
+			this->build_pending = false;
+		}
+
+		this->cond_done.notify_one();
+	}
+}
+
+// ---------------------------------------------------
+
+void RenderPipeline::wait_build ()
+{
+	std::unique_lock lock(this->mutex);
+	this->cond_done.wait(lock, [this] { return !this->build_pending; });
+}
+
+// ---------------------------------------------------
+
+void RenderPipeline::build (const uint32_t index)
+{
+	const RenderSnapshot& snapshot = this->snapshots[index];
+	DrawData& data = this->draw_data[index];
+	const DrawCounts counts = count_draw_data(snapshot);
+
+	data.render_args = snapshot.render_args;
+	data.targets = DrawTargets {
+		.triangles_texture = this->stream_triangles_texture.map(index, counts.n_triangles_texture),
+		.triangles_color = this->stream_triangles_color.map(index, counts.n_triangles_color),
+		.lines = this->stream_lines.map(index, counts.n_lines)
+	};
+
+	build_draw_data(snapshot, data.targets);
+
+	data.ready = true;
+}
+
+// ---------------------------------------------------
+
+template <typename Vertex>
+static void upload (const std::span<Vertex> dest, const std::span<Vertex> vertices)
+{
+	std::copy(vertices.begin(), vertices.end(), dest.begin());
+}
+
+void RenderPipeline::submit (DrawData& data)
+{
+	render_backend->setup_render_3D(data.render_args);
+
+	upload(render_backend->alloc_triangles_texture(data.targets.triangles_texture.size()), data.targets.triangles_texture);
+	upload(render_backend->alloc_triangles_color(data.targets.triangles_color.size()), data.targets.triangles_color);
+	upload(render_backend->alloc_lines(data.targets.lines.size()), data.targets.lines);
+
+	data.ready = false;
+}
+
+// ---------------------------------------------------
+
+void RenderPipeline::build_and_submit (const RenderSnapshot& snapshot)
+{
+	const DrawCounts counts = count_draw_data(snapshot);
+
+	render_backend->setup_render_3D(snapshot.render_args);
+
+	// no intermediate storage, we write straight into the renderer's buffers
+	build_draw_data(snapshot, DrawTargets {
+		.triangles_texture = render_backend->alloc_triangles_texture(counts.n_triangles_texture),
+		.triangles_color = render_backend->alloc_triangles_color(counts.n_triangles_color),
+		.lines = render_backend->alloc_lines(counts.n_lines)
+	});
+}
+
+// ---------------------------------------------------
+
+void RenderPipeline::end_frame ()
+{
+	const uint32_t current = this->recording;
+	const uint32_t previous = current ^ 1;
+
+	if constexpr (Config::threaded_render) {
+		this->wait_build();
+
+		if (this->draw_data[previous].ready)
+			this->submit(this->draw_data[previous]);
+
+		{
+			std::lock_guard lock(this->mutex);
+			this->build_index = current;
+			this->build_pending = true;
+		}
+
+		this->cond_request.notify_one();
+	}
+	else
+		this->build_and_submit(this->snapshots[current]);
+
+	this->recording = previous;
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
@@ -0,0 +1,138 @@
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/texture-cache.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+bool TextureCache::open (const char *fname, const uint64_t source_hash, const uint32_t n_textures)
+{
+	if (!this->file.open(fname))
+		return false;
+
+	const std::span<std::byte> data = this->file.get_data();
+
+	const uint64_t entries_offset = sizeof(Header);
+	const uint64_t entries_size = n_textures * sizeof(Entry);
+
+	if (data.size() < (entries_offset + entries_size)) {
+		this->file.close();
+		return false;
+	}
+
+	Header header;
+	std::memcpy(&header, data.data(), sizeof(Header));
+
+	if (header.magic != magic
+		|| header.version != version
+		|| header.n_textures != n_textures
+		|| header.source_hash != source_hash) {
+		this->file.close();
+		return false;
+	}
+
+	// mmap returns page-aligned memory, so the entries are properly aligned
+	this->entries = std::span<const Entry>(reinterpret_cast<const Entry*>(data.data() + entries_offset), n_textures);
+
+	for (const Entry& entry : this->entries) {
+		if (entry.format != SDL_PIXELFORMAT_RGBA32
+			|| entry.size != static_cast<uint64_t>(entry.pitch) * entry.height
+			|| (entry.offset + entry.size) > data.size()) {
+			this->entries = {};
+			this->file.close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------
+
+SDL_Surface* TextureCache::make_surface (const uint32_t i) const
+{
+	const Entry& entry = this->entries[i];
+
+	return SDL_CreateRGBSurfaceWithFormatFrom(this->file.get_data().data() + entry.offset,
+		entry.width, entry.height, 32, entry.pitch, entry.format);
+}
+
+// ---------------------------------------------------
+
+bool TextureCache::write (const char *fname, const uint64_t source_hash, const std::span<SDL_Surface* const> surfaces)
+{
+	const Header header = {
+		.magic = magic,
+		.version = version,
+		.n_textures = static_cast<uint32_t>(surfaces.size()),
+		.source_hash = source_hash
+	};
+
+	std::vector<Entry> entries(surfaces.size());
+
+	uint64_t offset = sizeof(Header) + surfaces.size() * sizeof(Entry);
+
+	for (uint32_t i = 0; i < surfaces.size(); i++) {
+		const SDL_Surface *surface = surfaces[i];
+		const uint32_t pitch = surface->w * 4;
+
+		mylib_assert_msg(surface->format->format == SDL_PIXELFORMAT_RGBA32, "texture cache requires RGBA32 surfaces");
+
+		offset = (offset + Entry::alignment - 1) / Entry::alignment * Entry::alignment;
+
+		entries[i] = Entry {
+			.width = static_cast<uint32_t>(surface->w),
+			.height = static_cast<uint32_t>(surface->h),
+			.pitch = pitch,
+			.format = SDL_PIXELFORMAT_RGBA32,
+			.offset = offset,
+			.size = static_cast<uint64_t>(pitch) * surface->h
+		};
+
+		offset += entries[i].size;
+	}
+
+	// write to a temporary file and rename it, so a crash never leaves a truncated cache behind
+	const std::string tmp_fname = std::string(fname) + ".tmp";
+
+	{
+		std::ofstream out(tmp_fname, std::ios::binary | std::ios::trunc);
+
+		if (!out)
+			return false;
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+
+		for (uint32_t i = 0; i < surfaces.size(); i++) {
+			const SDL_Surface *surface = surfaces[i];
+			const Entry& entry = entries[i];
+
+			// padding
+			while (static_cast<uint64_t>(out.tellp()) < entry.offset)
+				out.put(0);
+
+			// surface rows may be padded, so we copy them one by one
+			for (uint32_t row = 0; row < entry.height; row++)
+				out.write(static_cast<const char*>(surface->pixels) + row * surface->pitch, entry.pitch);
+		}
+
+		if (!out)
+			return false;
+	}
+
+	return (std::rename(tmp_fname.c_str(), fname) == 0);
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
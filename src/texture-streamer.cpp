@@ -0,0 +1,293 @@
+#include <limits>
+#include <algorithm>
+
+#include <SDL_image.h>
+
+#include <aurora/config.h>
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/globals.h>
+#include <aurora/graphics.h>
+#include <aurora/render.h>
+#include <aurora/render-backend.h>
+#include <aurora/asset-pack.h>
+#include <aurora/texture-streamer.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+static float distance_squared (const Point& a, const Point& b) noexcept
+{
+	const Vector d = a - b;
+	return d.x*d.x + d.y*d.y + d.z*d.z;
+}
+
+// ---------------------------------------------------
+
+TextureStreamer::~TextureStreamer ()
+{
+	this->stop();
+}
+
+// ---------------------------------------------------
+
+void TextureStreamer::add_request (Request&& request)
+{
+	mylib_assert_msg(!this->worker.joinable(), "textures must be requested before the streamer starts");
+
+	if (this->placeholder_surface == nullptr) {
+		this->placeholder_surface = SDL_CreateRGBSurfaceWithFormat(0, 1, 1, 32, SDL_PIXELFORMAT_RGBA32);
+		mylib_assert_msg(this->placeholder_surface != nullptr, "failed to create the placeholder texture");
+
+		// translucent grey
+		SDL_FillRect(this->placeholder_surface, nullptr, SDL_MapRGBA(this->placeholder_surface->format, 128, 128, 128, 96));
+	}
+
+	// every request has its own placeholder, so its sprites can be retargeted independently
+	request.placeholder = render_backend->load_texture(this->placeholder_surface);
+	*request.texture = request.placeholder;
+
+	this->placeholder_requests[request.placeholder.info] = this->requests.size();
+	this->requests.push_back(std::move(request));
+}
+
+void TextureStreamer::request (TextureDescriptor& texture, const char *fname)
+{
+	this->add_request( Request {
+		.texture = &texture,
+		.frames = nullptr,
+		.nrows = 0,
+		.ncols = 0,
+		.fname = fname
+	} );
+}
+
+void TextureStreamer::request (TextureDescriptor& texture, Mylib::Matrix<TextureDescriptor>& frames, const uint32_t nrows, const uint32_t ncols, const char *fname)
+{
+	this->add_request( Request {
+		.texture = &texture,
+		.frames = &frames,
+		.nrows = nrows,
+		.ncols = ncols,
+		.fname = fname
+	} );
+}
+
+// ---------------------------------------------------
+
+void TextureStreamer::start ()
+{
+	for (uint32_t i = 0; i < this->requests.size(); i++) {
+		Request& request = this->requests[i];
+
+		if (request.frames == nullptr)
+			continue;
+
+		request.placeholder_frames = render_backend->split_texture(request.placeholder, request.nrows, request.ncols);
+
+		// the only time the frames are allocated, afterwards they are written in place,
+		// so spans and pointers to them stay valid
+		*request.frames = request.placeholder_frames;
+
+		for (const TextureDescriptor& frame : request.placeholder_frames.to_span())
+			this->placeholder_requests[frame.info] = i;
+	}
+
+	if (!this->requests.empty())
+		this->worker = std::thread(&TextureStreamer::worker_loop, this);
+}
+
+// ---------------------------------------------------
+
+void TextureStreamer::stop ()
+{
+	if (this->worker.joinable()) {
+		{
+			std::lock_guard lock(this->mutex);
+			this->quit = true;
+		}
+
+		this->worker.join();
+	}
+
+	for (Request& request : this->requests) {
+		if (request.surface != nullptr) {
+			SDL_FreeSurface(request.surface);
+			request.surface = nullptr;
+		}
+	}
+
+	if (this->placeholder_surface != nullptr) {
+		SDL_FreeSurface(this->placeholder_surface);
+		this->placeholder_surface = nullptr;
+	}
+}
+
+// ---------------------------------------------------
+
+void TextureStreamer::worker_loop ()
+{
+	while (true) {
+		uint32_t next = this->requests.size();
+
+		{
+			std::lock_guard lock(this->mutex);
+
+			if (this->quit)
+				return;
+
+			// textures used near the player first, then the ones nobody uses yet in request order
+			float best_distance = std::numeric_limits<float>::max();
+
+			for (uint32_t i = 0; i < this->requests.size(); i++) {
+				const Request& request = this->requests[i];
+
+				if (request.state != State::Pending)
+					continue;
+
+				const float distance = request.has_pos ? distance_squared(request.pos, this->focus) : std::numeric_limits<float>::max();
+
+				if (next == this->requests.size() || distance < best_distance) {
+					next = i;
+					best_distance = distance;
+				}
+			}
+
+			if (next == this->requests.size())
+				return;
+
+			this->requests[next].state = State::Decoding;
+		}
+
+		AssetFile file;
+		SDL_Surface *surface = nullptr;
+
+		if (asset_files.open(file, this->requests[next].fname))
+			surface = IMG_Load_RW(file.make_rwops(), 1);
+
+		{
+			std::lock_guard lock(this->mutex);
+
+			this->requests[next].surface = surface;
+			this->requests[next].state = State::Decoded;
+			this->decoded.push_back(next);
+		}
+	}
+}
+
+// ---------------------------------------------------
+
+void TextureStreamer::set_focus (const Point& pos)
+{
+	if (this->is_done())
+		return;
+
+	std::lock_guard lock(this->mutex);
+	this->focus = pos;
+}
+
+// ---------------------------------------------------
+
+void TextureStreamer::hint (const TextureDescriptor& texture, const Point& pos)
+{
+	this->hint(texture, std::span<const Point>(&pos, 1));
+}
+
+void TextureStreamer::hint (const TextureDescriptor& texture, const std::span<const Point> positions)
+{
+	if (this->is_done() || positions.empty())
+		return;
+
+	const auto it = this->placeholder_requests.find(texture.info);
+
+	if (it == this->placeholder_requests.end())
+		return;
+
+	std::lock_guard lock(this->mutex);
+
+	Request& request = this->requests[it->second];
+
+	for (const Point& pos : positions) {
+		if (!request.has_pos || distance_squared(pos, this->focus) < distance_squared(request.pos, this->focus)) {
+			request.pos = pos;
+			request.has_pos = true;
+		}
+	}
+}
+
+// ---------------------------------------------------
+
+void TextureStreamer::process ()
+{
+	if (this->is_done())
+		return;
+
+	std::vector<uint32_t> ready;
+
+	{
+		std::lock_guard lock(this->mutex);
+		ready.swap(this->decoded);
+	}
+
+	if (ready.empty())
+		return;
+
+	// the render thread reads the sprite registry, so we can't retarget while it's building a frame
+	render_pipeline->wait_idle();
+
+	render_backend->begin_texture_loading();
+
+	for (const uint32_t i : ready) {
+		Request& request = this->requests[i];
+
+		mylib_assert_msg(request.surface != nullptr, "failed to load texture ", request.fname);
+
+		*request.texture = render_backend->load_texture(request.surface);
+		SDL_FreeSurface(request.surface);
+		request.surface = nullptr;
+	}
+
+	render_backend->end_texture_loading();
+
+	for (const uint32_t i : ready) {
+		Request& request = this->requests[i];
+
+		sprite_registry.retarget(request.placeholder, *request.texture);
+		this->placeholder_requests.erase(request.placeholder.info);
+
+		if (request.frames != nullptr) {
+			auto loaded_frames = render_backend->split_texture(*request.texture, request.nrows, request.ncols);
+
+			const auto placeholder_frames = request.placeholder_frames.to_span();
+			const auto frames = request.frames->to_span();
+
+			mylib_assert_msg(loaded_frames.to_span().size() == frames.size(), "split of ", request.fname, " doesn't match its placeholder");
+
+			std::ranges::copy(loaded_frames.to_span(), frames.begin());
+
+			for (uint32_t j = 0; j < frames.size(); j++) {
+				sprite_registry.retarget(placeholder_frames[j], frames[j]);
+				this->placeholder_requests.erase(placeholder_frames[j].info);
+			}
+		}
+
+		{
+			std::lock_guard lock(this->mutex);
+			request.state = State::Loaded;
+		}
+
+		this->n_loaded++;
+
+		dprintln("streamed texture ", request.fname);
+	}
+
+	if (this->is_done() && this->worker.joinable())
+		this->worker.join();
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
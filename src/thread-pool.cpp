@@ -0,0 +1,106 @@
+#include <aurora/types.h>
+#include <aurora/lib.h>
+#include <aurora/thread-pool.h>
+
+
+namespace Game
+{
+
+// ---------------------------------------------------
+
+ThreadPool::ThreadPool (const uint32_t n_workers)
+{
+	this->threads.reserve(n_workers);
+
+	for (uint32_t i = 0; i < n_workers; i++)
+		this->threads.emplace_back(&ThreadPool::worker_loop, this);
+}
+
+// ---------------------------------------------------
+
+ThreadPool::~ThreadPool ()
+{
+	{
+		std::lock_guard lock(this->mutex);
+		this->quit = true;
+	}
+
+	this->cond_job.notify_all();
+
+	for (std::thread& thread : this->threads)
+		thread.join();
+}
+
+// ---------------------------------------------------
+
+void ThreadPool::worker_loop ()
+{
+	uint64_t seen_generation = 0;
+
+	while (true) {
+		{
+			std::unique_lock lock(this->mutex);
+			this->cond_job.wait(lock, [this, seen_generation] { return this->quit || this->generation != seen_generation; });
+
+			if (this->quit)
+				return;
+
+			seen_generation = this->generation;
+			this->n_busy++;
+		}
+
+		this->execute_tasks();
+
+		{
+			std::lock_guard lock(this->mutex);
+			this->n_busy--;
+		}
+
+		this->cond_done.notify_all();
+	}
+}
+
+// ---------------------------------------------------
+
+void ThreadPool::execute_tasks ()
+{
+	uint32_t task;
+
+	while ((task = this->next_task.fetch_add(1)) < this->n_tasks) {
+		this->function(this->ctx, task);
+		this->n_done.fetch_add(1);
+	}
+}
+
+// ---------------------------------------------------
+
+void ThreadPool::run_job (const uint32_t n_tasks_, TaskFunction function_, void *ctx_)
+{
+	if (n_tasks_ == 0)
+		return;
+
+	{
+		std::unique_lock lock(this->mutex);
+
+		// late workers of the previous job may still be leaving execute_tasks
+		this->cond_done.wait(lock, [this] { return this->n_busy == 0; });
+
+		this->function = function_;
+		this->ctx = ctx_;
+		this->n_tasks = n_tasks_;
+		this->next_task = 0;
+		this->n_done = 0;
+		this->generation++;
+	}
+
+	this->cond_job.notify_all();
+
+	this->execute_tasks();
+
+	std::unique_lock lock(this->mutex);
+	this->cond_done.wait(lock, [this] { return this->n_done == this->n_tasks; });
+}
+
+// ---------------------------------------------------
+
+} // end namespace Game
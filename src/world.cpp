@@ -1,5 +1,6 @@
 #include <limits>
-#include <iterator>
+#include <array>
+#include <utility>
 
 #include <aurora/config.h>
 #include <aurora/types.h>
@@ -8,7 +9,11 @@
 #include <aurora/graphics.h>
 #include <aurora/audio.h>
 #include <aurora/object.h>
+#include <aurora/blueprint.h>
 #include <aurora/world.h>
+#include <aurora/render.h>
+#include <aurora/render-backend.h>
+#include <aurora/texture-streamer.h>
 
 
 namespace Game
@@ -103,8 +108,6 @@ Map::Map (World *world_)
 
 	// generate graphics vertices
 
-	using enum MyGlib::Graphics::Enums::TextureVertexPositionIndex;
-
 	this->graphics_vertices.resize((this->vertices.get_nrows()-1) * (this->vertices.get_ncols()-1) * 6);
 
 	uint32_t k = 0;
@@ -127,7 +130,7 @@ Map::Map (World *world_)
 
 			// select texture from tile map
 
-			const Opengl_TextureDescriptor *desc = get_tile_texture(i, j).info->data.get_value<Opengl_TextureDescriptor*>();
+			const TextureCoords tex_coords = render_backend->get_texture_coords(get_tile_texture(i, j));
 
 			// doing counter clock-wise
 
@@ -137,9 +140,9 @@ Map::Map (World *world_)
 			gv[EastSouth].offset = this->vertices[i+1, j].pos;
 			gv[WestNorth].offset = this->vertices[i, j+1].pos;
 
-			gv[WestSouth].tex_coords = Vector(desc->tex_coords[LeftBottom].x, desc->tex_coords[LeftBottom].y, desc->atlas->texture_depth);
-			gv[EastSouth].tex_coords = Vector(desc->tex_coords[RightBottom].x, desc->tex_coords[RightBottom].y, desc->atlas->texture_depth);
-			gv[WestNorth].tex_coords = Vector(desc->tex_coords[LeftTop].x, desc->tex_coords[LeftTop].y, desc->atlas->texture_depth);
+			gv[WestSouth].tex_coords = tex_coords.left_bottom;
+			gv[EastSouth].tex_coords = tex_coords.right_bottom;
+			gv[WestNorth].tex_coords = tex_coords.left_top;
 
 			// second triangle
 
@@ -148,7 +151,7 @@ Map::Map (World *world_)
 			gv[WestNorthRepeat].offset = gv[WestNorth].offset;
 
 			gv[EastSouthRepeat].tex_coords = gv[EastSouth].tex_coords;
-			gv[EastNorth].tex_coords = Vector(desc->tex_coords[RightTop].x, desc->tex_coords[RightTop].y, desc->atlas->texture_depth);
+			gv[EastNorth].tex_coords = tex_coords.right_top;
 			gv[WestNorthRepeat].tex_coords = gv[WestNorth].tex_coords;
 
 			// calculate normals
@@ -174,13 +177,8 @@ Map::Map (World *world_)
 
 void Map::render (const float dt)
 {
-	MyGlib::Graphics::Opengl::Renderer *opengl_renderer = static_cast<MyGlib::Graphics::Opengl::Renderer*>(renderer);
-	MyGlib::Graphics::Opengl::ProgramTriangleTexture& program = *opengl_renderer->get_program_triangle_texture();
-	const uint32_t n_vertices = this->graphics_vertices.size();
-	auto vertices = program.alloc_vertices(n_vertices);
-
-	for (uint32_t i = 0; i < n_vertices; i++)
-		vertices[i] = this->graphics_vertices[i];
+	// the terrain mesh never changes, so the snapshot can reference it
+	render_pipeline->get_recording_snapshot().terrain = this->graphics_vertices;
 }
 
 // ---------------------------------------------------
@@ -244,6 +242,14 @@ float Map::get_z (const Vector2& pos) const noexcept
 	return intersection.z;
 }
 
+void Map::get_z (const std::span<const Point2> positions, const std::span<float> out) const noexcept
+{
+	mylib_assert_msg(positions.size() == out.size(), "positions and out must have the same size");
+
+	for (uint32_t i = 0; i < positions.size(); i++)
+		out[i] = this->get_z(positions[i]);
+}
+
 // ---------------------------------------------------
 
 World::World ()
@@ -252,18 +258,24 @@ World::World ()
 	this->camera_pos = Vector(-3, -3, 5);
 	this->ambient_light_color.a = 0;
 
-	this->light = renderer->add_light_point_source(
+	this->light = render_backend->add_light_point_source(
 		Point(-10, -10, 100), Colors::white
 	);
 
 	this->add_static_object_at_ground( build_static_object_sprite(this, Object::Subtype::Castle_00, Point(10, 10, foo<float>)) );
-	this->add_static_object_at_ground( build_static_object_sprite(this, Object::Subtype::Tree_00, Point(1, 9, foo<float>)) );
-	this->add_static_object_at_ground( build_static_object_sprite(this, Object::Subtype::Tree_00, Point(3, 3, foo<float>)) );
-	this->add_static_object_at_ground( build_static_object_sprite(this, Object::Subtype::Tree_00, Point(18, 2, foo<float>)) );
-	this->add_static_object_at_ground( build_static_object_sprite(this, Object::Subtype::Tree_00, Point(5, 16, foo<float>)) );
+
+	const auto trees = std::to_array<Point2>({
+		Point2(1, 9),
+		Point2(3, 3),
+		Point2(18, 2),
+		Point2(5, 16)
+	});
+
+	this->add_props_at_ground(Object::Subtype::Tree_00, trees);
+
 	this->add_object( std::make_unique<EnemyObject>(this, std::initializer_list<Point2> { Point2(1, 1), Point2(3, 1) } ) );
 	this->add_object( std::make_unique<EnemyObject>(this, std::initializer_list<Point2> { Point2(1, 10), Point2(6, 10) } ) );
-	this->player = static_cast<PlayerObject*>( this->add_object( std::make_unique<PlayerObject>(this, Vector(1, 1, 3)) ) );
+	this->player = this->add_object( std::make_unique<PlayerObject>(this, Vector(1, 1, 3)) )->get_value_handle();
 
 	audio_manager->set_volume(Audio::background_music, 0.3f);
 	audio_manager->play_audio(Audio::background_music);
@@ -273,18 +285,25 @@ World::World ()
 
 void World::process_physics (const float dt) noexcept
 {
-	for (DynamicObject *obj : this->dynamic_objects)
+	for (auto& obj : this->dynamic_objects)
 		obj->physics(dt);
 
 	this->process_map_collision();
 	this->process_object_collision();
+
+	for (const CollisionEvent& event : this->collision_events) {
+		event.a->object->collision(*event.a, *event.b, event.ds);
+		event.b->object->collision(*event.b, *event.a, event.ds);
+	}
+
+	this->collision_events.clear();
 }
 
 // ---------------------------------------------------
 
 void World::process_map_collision () noexcept
 {
-	for (DynamicObject *obj : this->dynamic_objects) {
+	for (auto& obj : this->dynamic_objects) {
 		Vector& obj_pos = obj->get_ref_pos();
 
 		for (Collider& collider : obj->get_colliders()) {
@@ -305,82 +324,154 @@ void World::process_map_collision () noexcept
 
 void World::process_object_collision () noexcept
 {
+	/*
+		The broadphase only returns the pairs of colliders that overlap in x.
+		Each pair is then tested with the colliders' current boxes, since
+		solving a collision moves the objects.
+		Static colliders get the lowest ids, so a pair with a static collider
+		has it as "a".
+	*/
+
+	this->step_colliders.clear();
+	this->broadphase_boxes.clear();
+	this->broadphase_pairs.clear();
+
+	auto add_collider = [this] (Collider& collider) {
+		const float x = collider.object->get_ref_pos().x + collider.ds.x;
+		const float half_x = collider.size.x / fp(2);
+
+		this->broadphase_boxes.push_back( BroadphaseBox {
+			.min_x = x - half_x,
+			.max_x = x + half_x,
+			.id = static_cast<uint32_t>(this->step_colliders.size())
+		} );
+
+		this->step_colliders.push_back(&collider);
+	};
+
+	for (auto& s_obj : this->static_objects) {
+		for (Collider& s_collider : s_obj->get_colliders())
+			add_collider(s_collider);
+	}
+
+	const uint32_t n_static_colliders = this->step_colliders.size();
+
+	for (auto& d_obj : this->dynamic_objects) {
+		for (Collider& d_collider : d_obj->get_colliders())
+			add_collider(d_collider);
+	}
+
+	sweep_and_prune(this->broadphase_boxes, this->broadphase_pairs);
+
+	for (BroadphasePair& pair : this->broadphase_pairs) {
+		if (pair.a > pair.b)
+			std::swap(pair.a, pair.b);
+	}
+
 	// Dynamic objects to static objects
-	
-	for (DynamicObject *d_obj : this->dynamic_objects) {
-		for (Collider& d_collider : d_obj->get_colliders()) {
-			for (StaticObject *s_obj : this->static_objects) {
-				for (Collider& s_collider : s_obj->get_colliders()) {
-					const auto [colliding, ds] = check_collision(s_collider, d_collider);
-					const auto abs_ds = Mylib::Math::abs(ds);
-
-					if (colliding) {
-						if (abs_ds.x <= abs_ds.y && abs_ds.x <= abs_ds.z) {
-							d_obj->get_ref_vel().x = 0;
-							d_obj->get_ref_pos().x += ds.x;
-						}
-						else if (abs_ds.y <= abs_ds.x && abs_ds.y <= abs_ds.z) {
-							d_obj->get_ref_vel().y = 0;
-							d_obj->get_ref_pos().y += ds.y;
-						}
-						else {
-							d_obj->get_ref_vel().z = 0;
-							d_obj->get_ref_pos().z += ds.z;
-						}
-
-						d_obj->collision(d_collider, s_collider, ds);
-						s_obj->collision(s_collider, d_collider, ds);
-					}
-				}
+
+	for (const BroadphasePair& pair : this->broadphase_pairs) {
+		if (pair.a >= n_static_colliders || pair.b < n_static_colliders)
+			continue;
+
+		Collider& s_collider = *this->step_colliders[pair.a];
+		Collider& d_collider = *this->step_colliders[pair.b];
+
+		// the kind tag guarantees the cast is valid
+		DynamicObject *d_obj = static_cast<DynamicObject*>(d_collider.object);
+
+		Vec4 ds4;
+
+		if (test_collision(s_collider.get_box(), d_collider.get_box(), ds4)) {
+			const Vector ds = ds4.to_vector();
+			const auto abs_ds = Mylib::Math::abs(ds);
+
+			if (abs_ds.x <= abs_ds.y && abs_ds.x <= abs_ds.z) {
+				d_obj->get_ref_vel().x = 0;
+				d_obj->get_ref_pos().x += ds.x;
+			}
+			else if (abs_ds.y <= abs_ds.x && abs_ds.y <= abs_ds.z) {
+				d_obj->get_ref_vel().y = 0;
+				d_obj->get_ref_pos().y += ds.y;
 			}
+			else {
+				d_obj->get_ref_vel().z = 0;
+				d_obj->get_ref_pos().z += ds.z;
+			}
+
+			this->collision_events.push_back( CollisionEvent {
+				.a = &d_collider,
+				.b = &s_collider,
+				.ds = ds
+			} );
 		}
 	}
 
 	// Dynamic objects to dynamic objects
-	
-	for (auto it_a = this->dynamic_objects.begin(); it_a != this->dynamic_objects.end(); it_a++) {
-		DynamicObject *obj_a = *it_a;
-
-		for (auto it_b = std::next(it_a); it_b != this->dynamic_objects.end(); it_b++) {
-			DynamicObject *obj_b = *it_b;
-
-			for (Collider& collider_a : obj_a->get_colliders()) {
-				for (Collider& collider_b : obj_b->get_colliders()) {
-					const auto [colliding, ds] = check_collision(collider_a, collider_b);
-					const auto abs_ds = Mylib::Math::abs(ds);
-
-					if (colliding) {
-						if (abs_ds.x <= abs_ds.y && abs_ds.x <= abs_ds.z) {
-							obj_a->get_ref_pos().x -= ds.x / fp(2);
-							obj_b->get_ref_pos().x += ds.x / fp(2);
-						}
-						else if (abs_ds.y <= abs_ds.x && abs_ds.y <= abs_ds.z) {
-							obj_a->get_ref_pos().y -= ds.y / fp(2);
-							obj_b->get_ref_pos().y += ds.y / fp(2);
-						}
-						else {
-							obj_a->get_ref_pos().z -= ds.z / fp(2);
-							obj_b->get_ref_pos().z += ds.z / fp(2);
-						}
-
-						obj_a->collision(collider_a, collider_b, ds);
-						obj_b->collision(collider_b, collider_a, ds);
-					}
-				}
+
+	for (const BroadphasePair& pair : this->broadphase_pairs) {
+		if (pair.a < n_static_colliders)
+			continue;
+
+		Collider& collider_a = *this->step_colliders[pair.a];
+		Collider& collider_b = *this->step_colliders[pair.b];
+
+		// objects don't collide with themselves
+		if (collider_a.object == collider_b.object)
+			continue;
+
+		StaticObject *obj_a = collider_a.object;
+		StaticObject *obj_b = collider_b.object;
+
+		Vec4 ds4;
+
+		if (test_collision(collider_a.get_box(), collider_b.get_box(), ds4)) {
+			const Vector ds = ds4.to_vector();
+			const auto abs_ds = Mylib::Math::abs(ds);
+
+			if (abs_ds.x <= abs_ds.y && abs_ds.x <= abs_ds.z) {
+				obj_a->get_ref_pos().x -= ds.x / fp(2);
+				obj_b->get_ref_pos().x += ds.x / fp(2);
 			}
+			else if (abs_ds.y <= abs_ds.x && abs_ds.y <= abs_ds.z) {
+				obj_a->get_ref_pos().y -= ds.y / fp(2);
+				obj_b->get_ref_pos().y += ds.y / fp(2);
+			}
+			else {
+				obj_a->get_ref_pos().z -= ds.z / fp(2);
+				obj_b->get_ref_pos().z += ds.z / fp(2);
+			}
+
+			this->collision_events.push_back( CollisionEvent {
+				.a = &collider_a,
+				.b = &collider_b,
+				.ds = ds
+			} );
 		}
 	}
 }
 
 // ---------------------------------------------------
 
-void World::render (const float dt)
+void World::render (const float dt, const float alpha)
 {
-	this->camera_pos = this->player->get_ref_pos() - Config::camera_vector * fp(50);
+	RenderSnapshot& snapshot = render_pipeline->get_recording_snapshot();
+
+	const StaticObject *player = this->get_object(this->player);
+
+	mylib_assert_msg(player != nullptr, "the player was destroyed");
+
+	// the camera follows the interpolated player, otherwise the player would jitter on screen
+	const Point player_pos = interpolate_pos(player->get_ref_previous_pos(), player->get_ref_pos(), alpha);
 
-	renderer->setup_render_3D( MyGlib::Graphics::RenderArgs3D {
+	this->camera_pos = player_pos - Config::camera_vector * fp(50);
+
+	texture_streamer.set_focus(player_pos);
+
+	snapshot.alpha = alpha;
+	snapshot.render_args = MyGlib::Graphics::RenderArgs3D {
 		.world_camera_pos = this->camera_pos,
-		.world_camera_target = this->player->get_ref_pos(),
+		.world_camera_target = player_pos,
 		.world_camera_up = Config::camera_up,
 		.projection = MyGlib::Graphics::OrthogonalProjectionInfo {
 			.view_width = 10,
@@ -388,36 +479,75 @@ void World::render (const float dt)
 			.z_far = 100,
 		},
 		.ambient_light_color = this->ambient_light_color,
-		} );
+	};
 
 	this->map->render(dt);
 
-	for (auto& obj : this->objects)
+	for (auto& obj : this->static_objects)
 		obj->render(dt);
+	for (auto& obj : this->dynamic_objects)
+		obj->render(dt);
+
+	this->effects.render();
+
+	// debug-draw layer
+
+	snapshot.sprite_boxes = debug_draw.sprite_boxes;
+
+	if (debug_draw.colliders) {
+		for (const auto& obj : this->static_objects)
+			obj->render_colliders(Colors::red);
+		for (const auto& obj : this->dynamic_objects)
+			obj->render_colliders(Colors::red);
+	}
 }
 
 // ---------------------------------------------------
 
 void World::process_update (const float dt)
 {
-	for (auto& obj : this->objects)
-		obj->update(dt);
+	// indices instead of iterators, since updates may add objects
+	for (uint32_t i = 0; i < this->static_objects.size(); i++)
+		this->static_objects[i]->update(dt);
+	for (uint32_t i = 0; i < this->dynamic_objects.size(); i++)
+		this->dynamic_objects[i]->update(dt);
+
+	this->effects.update(dt);
 }
 
 // ---------------------------------------------------
 
-Object* World::add_object (std::unique_ptr<Object> object)
+void World::store_previous_state () noexcept
+{
+	// only dynamic objects move between simulation steps
+	for (auto& obj : this->dynamic_objects)
+		obj->store_previous_state();
+}
+
+// ---------------------------------------------------
+
+void World::insert_object (Object *object)
 {
-	Object *obj = object.get();
-	this->objects.push_back( std::move(object) );
+	switch (object->get_kind()) {
+		case ObjectKind::Static:
+			this->insert_object_in_bucket<ObjectKind::Static>(object);
+		break;
 
-	// careful since a dynamic object is also a static object
+		case ObjectKind::Dynamic:
+			this->insert_object_in_bucket<ObjectKind::Dynamic>(object);
+		break;
 
-	if (DynamicObject *d_obj = dynamic_cast<DynamicObject*>(obj))
-		this->dynamic_objects.push_back(d_obj);
-	else if (StaticObject *s_obj = dynamic_cast<StaticObject*>(obj))
-		this->static_objects.push_back(s_obj);
+		default:
+			mylib_assert_msg(0, "the world only stores static and dynamic objects, got ", object->get_subtype());
+	}
+}
 
+// ---------------------------------------------------
+
+Object* World::add_object (std::unique_ptr<Object> object)
+{
+	Object *obj = object.release();
+	this->insert_object(obj);
 	return obj;
 }
 
@@ -447,19 +577,74 @@ StaticObject* World::add_static_object_at_ground (std::unique_ptr<StaticObject>
 
 // ---------------------------------------------------
 
+void World::add_props_at_ground (const Object::Subtype subtype, const std::span<const Point2> positions)
+{
+	const Blueprint& blueprint = blueprint_registry.get(subtype);
+
+	const uint32_t n = positions.size();
+
+	this->static_objects.reserve(this->static_objects.size() + n);
+	this->prop_pool.reserve(n);
+
+	this->spawn_ground_z.resize(n);
+	this->map->get_z(positions, this->spawn_ground_z);
+
+	// all props of the blueprint share the collider, so they stand at the same height above the ground
+	const float z_above_ground = blueprint.collider_size.z / fp(2);
+
+	this->spawn_pos.resize(n);
+
+	for (uint32_t i = 0; i < n; i++)
+		this->spawn_pos[i] = Point(positions[i].x, positions[i].y, this->spawn_ground_z[i] + z_above_ground);
+
+	// all props share the sprite, so it is interned and streamed once for the whole batch
+	const SpriteRegistry::Id sprite_id = sprite_registry.intern(*blueprint.texture, blueprint.sprite_size, blueprint.sprite_source_anchor, blueprint.sprite_dest_anchor);
+	texture_streamer.hint(*blueprint.texture, this->spawn_pos);
+
+	for (uint32_t i = 0; i < n; i++) {
+		StaticObjectSprite *obj = this->prop_pool.construct(this, blueprint.subtype, this->spawn_pos[i], *blueprint.texture, sprite_id);
+
+		add_blueprint_collider(obj, blueprint);
+
+		this->insert_object_in_bucket<ObjectKind::Static>(obj);
+	}
+}
+
+// ---------------------------------------------------
+
+StaticObject* World::get_object (const ObjectHandle handle) noexcept
+{
+	switch (handle.kind) {
+		case ObjectKind::Static:
+			return this->get_object_in_bucket<ObjectKind::Static>(handle.slot);
+
+		case ObjectKind::Dynamic:
+			return this->get_object_in_bucket<ObjectKind::Dynamic>(handle.slot);
+
+		default:
+			return nullptr;
+	}
+}
+
+// ---------------------------------------------------
+
 void World::frame_finished ()
 {
-	for (Object *obj : this->objects_to_remove_next_frame) {
-		// careful since a dynamic object is also a static object
+	// each object is queued at most once, and removal is O(1), so removing K objects costs O(K)
 
-		if (DynamicObject *d_obj = dynamic_cast<DynamicObject*>(obj))
-			this->dynamic_objects.remove(d_obj);
-		else if (StaticObject *s_obj = dynamic_cast<StaticObject*>(obj))
-			this->static_objects.remove(s_obj);
-		
-		this->objects.remove_if([obj](const std::unique_ptr<Object>& ptr) -> bool {
-			return ptr.get() == obj;
-		});
+	for (const ObjectHandle handle : this->objects_to_remove_next_frame) {
+		switch (handle.kind) {
+			case ObjectKind::Static:
+				this->get_bucket<ObjectKind::Static>().erase(handle.slot);
+			break;
+
+			case ObjectKind::Dynamic:
+				this->get_bucket<ObjectKind::Dynamic>().erase(handle.slot);
+			break;
+
+			default:
+				mylib_assert(0)
+		}
 	}
 
 	this->objects_to_remove_next_frame.clear();
@@ -0,0 +1,132 @@
+/*
+	Builds the asset pack read by the game (see include/aurora/asset-pack-format.h).
+	Entries are named after their path, e.g., "assets/grass.png", which is
+	the same path the game uses to load them.
+
+	usage: pack-assets <assets directory> <output file>
+*/
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <cstdlib>
+#include <cstdio>
+
+#include <aurora/asset-pack-format.h>
+
+using namespace Game::AssetPackFormat;
+
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------
+
+// generated files, they must not be packed
+static bool skip_file (const fs::path& path)
+{
+	const std::string ext = path.extension().string();
+	return (ext == ".cache" || ext == ".tmp" || ext == ".pack");
+}
+
+// ---------------------------------------------------
+
+int main (int argc, char **argv)
+{
+	if (argc != 3) {
+		std::cerr << "usage: " << argv[0] << " <assets directory> <output file>" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const fs::path dir = argv[1];
+	const std::string out_fname = argv[2];
+
+	std::vector<fs::path> files;
+
+	for (const fs::directory_entry& dir_entry : fs::recursive_directory_iterator(dir)) {
+		if (dir_entry.is_regular_file() && !skip_file(dir_entry.path()))
+			files.push_back(dir_entry.path());
+	}
+
+	// the game finds entries by binary search
+	std::sort(files.begin(), files.end(), [] (const fs::path& a, const fs::path& b) -> bool {
+		return a.generic_string() < b.generic_string();
+	});
+
+	std::vector<Entry> entries(files.size());
+	std::string names;
+
+	for (size_t i = 0; i < files.size(); i++) {
+		const std::string name = files[i].generic_string();
+
+		entries[i].name_offset = names.size();
+		entries[i].name_size = name.size();
+		entries[i].size = fs::file_size(files[i]);
+
+		names += name;
+	}
+
+	const Header header = {
+		.magic = magic,
+		.version = version,
+		.n_entries = static_cast<uint32_t>(entries.size()),
+		.names_offset = sizeof(Header) + entries.size() * sizeof(Entry),
+		.names_size = names.size()
+	};
+
+	uint64_t offset = header.names_offset + header.names_size;
+
+	for (Entry& entry : entries) {
+		offset = (offset + alignment - 1) / alignment * alignment;
+		entry.offset = offset;
+		offset += entry.size;
+	}
+
+	const std::string tmp_fname = out_fname + ".tmp";
+
+	{
+		std::ofstream out(tmp_fname, std::ios::binary | std::ios::trunc);
+
+		if (!out) {
+			std::cerr << "cannot create " << tmp_fname << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+		out.write(names.data(), names.size());
+
+		for (size_t i = 0; i < files.size(); i++) {
+			std::ifstream in(files[i], std::ios::binary);
+
+			if (!in) {
+				std::cerr << "cannot read " << files[i] << std::endl;
+				return EXIT_FAILURE;
+			}
+
+			// padding
+			while (static_cast<uint64_t>(out.tellp()) < entries[i].offset)
+				out.put(0);
+
+			out << in.rdbuf();
+
+			std::cout << files[i].generic_string() << " " << entries[i].size << " bytes" << std::endl;
+		}
+
+		if (!out) {
+			std::cerr << "failed to write " << tmp_fname << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (std::rename(tmp_fname.c_str(), out_fname.c_str()) != 0) {
+		std::cerr << "cannot rename " << tmp_fname << " to " << out_fname << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "packed " << files.size() << " files into " << out_fname << std::endl;
+
+	return EXIT_SUCCESS;
+}